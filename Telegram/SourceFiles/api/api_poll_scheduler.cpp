@@ -0,0 +1,100 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "api/api_poll_scheduler.h"
+
+#include "core/application.h"
+
+namespace Api {
+namespace {
+
+constexpr auto kWakeupStep = crl::time(1000);
+constexpr auto kMaxSharedShiftPart = 4;
+constexpr auto kInactiveDelayMultiplier = 4;
+constexpr auto kStatsPeriod = 60 * crl::time(1000);
+
+} // namespace
+
+PollScheduler::PollScheduler(not_null<ApiWrap*> api) {
+	Core::App().appDeactivatedValue(
+	) | rpl::start_with_next([=](bool deactivated) {
+		_inactive = deactivated;
+		if (!deactivated) {
+			activated();
+		}
+	}, _lifetime);
+}
+
+void PollScheduler::callOnce(
+		not_null<base::Timer*> timer,
+		crl::time delay,
+		bool background) {
+	_stretched.remove(timer);
+	if (delay < kWakeupStep) {
+		// Forced polls and short batching delays go as requested.
+		timer->callOnce(delay);
+		return;
+	}
+	const auto now = crl::now();
+	const auto stretched = background && _inactive;
+	if (stretched) {
+		_stretched.emplace(timer, now + delay);
+		delay *= kInactiveDelayMultiplier;
+	}
+	const auto wanted = now + delay;
+	_wakeups.erase(begin(_wakeups), _wakeups.upper_bound(now));
+
+	// Join a wakeup planned by some other poll if it is close enough,
+	// so that all the requests are sent together in one container.
+	const auto i = _wakeups.lower_bound(wanted);
+	const auto shared = (i != end(_wakeups))
+		&& (*i - wanted <= delay / kMaxSharedShiftPart);
+	const auto when = shared
+		? *i
+		: (((wanted + kWakeupStep - 1) / kWakeupStep) * kWakeupStep);
+	_wakeups.emplace(when);
+	timer->callOnce(when - now);
+	countWakeup(now, shared, stretched);
+}
+
+void PollScheduler::cancel(not_null<base::Timer*> timer) {
+	_stretched.remove(timer);
+	timer->cancel();
+}
+
+void PollScheduler::activated() {
+	const auto now = crl::now();
+	for (const auto &[timer, when] : base::take(_stretched)) {
+		if (timer->isActive()) {
+			callOnce(timer, std::max(when - now, crl::time(1)));
+		}
+	}
+}
+
+void PollScheduler::countWakeup(crl::time now, bool shared, bool stretched) {
+	if (!_statsStarted) {
+		_statsStarted = now;
+	} else if (now - _statsStarted >= kStatsPeriod) {
+		DEBUG_LOG(("Poll Scheduler: "
+			"%1 wakeups in %2 ms, %3 shared, %4 stretched while inactive."
+			).arg(_statsWakeups
+			).arg(now - _statsStarted
+			).arg(_statsShared
+			).arg(_statsStretched));
+		_statsStarted = now;
+		_statsWakeups = _statsShared = _statsStretched = 0;
+	}
+	++_statsWakeups;
+	if (shared) {
+		++_statsShared;
+	}
+	if (stretched) {
+		++_statsStretched;
+	}
+}
+
+} // namespace Api
@@ -0,0 +1,45 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/timer.h"
+
+class ApiWrap;
+
+namespace Api {
+
+class PollScheduler final {
+public:
+	explicit PollScheduler(not_null<ApiWrap*> api);
+
+	// Starts the timer at the first shared wakeup not earlier than delay.
+	// Background polls are stretched while the app is not active.
+	void callOnce(
+		not_null<base::Timer*> timer,
+		crl::time delay,
+		bool background = true);
+	void cancel(not_null<base::Timer*> timer);
+
+private:
+	void activated();
+	void countWakeup(crl::time now, bool shared, bool stretched);
+
+	base::flat_set<crl::time> _wakeups;
+	base::flat_map<not_null<base::Timer*>, crl::time> _stretched;
+	bool _inactive = false;
+
+	crl::time _statsStarted = 0;
+	int _statsWakeups = 0;
+	int _statsShared = 0;
+	int _statsStretched = 0;
+
+	rpl::lifetime _lifetime;
+
+};
+
+} // namespace Api
@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "api/api_views.h"
 
+#include "api/api_poll_scheduler.h"
 #include "apiwrap.h"
 #include "data/data_peer.h"
 #include "data/data_peer_id.h"
@@ -46,7 +47,10 @@ void ViewsManager::scheduleIncrement(not_null<HistoryItem*> item) {
 	auto j = _toIncrement.find(peer);
 	if (j == _toIncrement.cend()) {
 		j = _toIncrement.emplace(peer).first;
-		_incrementTimer.callOnce(kSendViewsTimeout);
+		_session->api().pollScheduler().callOnce(
+			&_incrementTimer,
+			kSendViewsTimeout,
+			false);
 	}
 	j->second.emplace(item->id);
 }
@@ -78,10 +82,14 @@ void ViewsManager::pollExtendedMedia(
 		request.when = crl::now() + delay;
 	}
 	if (!_pollTimer.isActive() || force) {
-		_pollTimer.callOnce(delay);
+		schedulePoll(delay);
 	}
 }
 
+void ViewsManager::schedulePoll(crl::time delay) {
+	_session->api().pollScheduler().callOnce(&_pollTimer, delay);
+}
+
 void ViewsManager::viewsIncrement() {
 	for (auto i = _toIncrement.begin(); i != _toIncrement.cend();) {
 		if (_incrementRequests.contains(i->first)) {
@@ -143,7 +151,7 @@ void ViewsManager::sendPollRequests() {
 	}
 	sendPollRequests(toRequest);
 	if (nearest) {
-		_pollTimer.callOnce(std::max(nearest - now, crl::time(1)));
+		schedulePoll(std::max(nearest - now, crl::time(1)));
 	}
 }
 
@@ -173,7 +181,7 @@ void ViewsManager::sendPollRequests(
 							: kPollExtendedMediaPeriod;
 						i->second.when = now + delay;
 						if (!_pollTimer.isActive() || i->second.forced) {
-							_pollTimer.callOnce(delay);
+							schedulePoll(delay);
 						}
 						++i;
 					}
@@ -233,7 +241,10 @@ void ViewsManager::done(
 		}
 	}
 	if (!_toIncrement.empty() && !_incrementTimer.isActive()) {
-		_incrementTimer.callOnce(kSendViewsTimeout);
+		_session->api().pollScheduler().callOnce(
+			&_incrementTimer,
+			kSendViewsTimeout,
+			false);
 	}
 }
 
@@ -245,7 +256,10 @@ void ViewsManager::fail(const MTP::Error &error, mtpRequestId requestId) {
 		}
 	}
 	if (!_toIncrement.empty() && !_incrementTimer.isActive()) {
-		_incrementTimer.callOnce(kSendViewsTimeout);
+		_session->api().pollScheduler().callOnce(
+			&_incrementTimer,
+			kSendViewsTimeout,
+			false);
 	}
 }
 
@@ -38,6 +38,7 @@ private:
 	};
 
 	void viewsIncrement();
+	void schedulePoll(crl::time delay);
 	void sendPollRequests();
 	void sendPollRequests(
 		const base::flat_map<
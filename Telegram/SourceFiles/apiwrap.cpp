@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_media.h"
 #include "api/api_peer_colors.h"
 #include "api/api_peer_photo.h"
+#include "api/api_poll_scheduler.h"
 #include "api/api_polls.h"
 #include "api/api_sending.h"
 #include "api/api_text_entities.h"
@@ -177,7 +178,8 @@ ApiWrap::ApiWrap(not_null<Main::Session*> session)
 , _premium(std::make_unique<Api::Premium>(this))
 , _usernames(std::make_unique<Api::Usernames>(this))
 , _websites(std::make_unique<Api::Websites>(this))
-, _peerColors(std::make_unique<Api::PeerColors>(this)) {
+, _peerColors(std::make_unique<Api::PeerColors>(this))
+, _pollScheduler(std::make_unique<Api::PollScheduler>(this)) {
 	crl::on_main(session, [=] {
 		// You can't use _session->lifetime() in the constructor,
 		// only queued, because it is not constructed yet.
@@ -4586,6 +4588,10 @@ Api::ViewsManager &ApiWrap::views() {
 	return *_views;
 }
 
+Api::PollScheduler &ApiWrap::pollScheduler() {
+	return *_pollScheduler;
+}
+
 Api::ConfirmPhone &ApiWrap::confirmPhone() {
 	return *_confirmPhone;
 }
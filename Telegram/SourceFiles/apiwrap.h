@@ -72,6 +72,7 @@ class UserPrivacy;
 class InviteLinks;
 class ChatLinks;
 class ViewsManager;
+class PollScheduler;
 class ConfirmPhone;
 class PeerPhoto;
 class PeerColors;
@@ -396,6 +397,7 @@ public:
 	[[nodiscard]] Api::InviteLinks &inviteLinks();
 	[[nodiscard]] Api::ChatLinks &chatLinks();
 	[[nodiscard]] Api::ViewsManager &views();
+	[[nodiscard]] Api::PollScheduler &pollScheduler();
 	[[nodiscard]] Api::ConfirmPhone &confirmPhone();
 	[[nodiscard]] Api::PeerPhoto &peerPhoto();
 	[[nodiscard]] Api::Polls &polls();
@@ -744,6 +746,7 @@ private:
 	const std::unique_ptr<Api::Usernames> _usernames;
 	const std::unique_ptr<Api::Websites> _websites;
 	const std::unique_ptr<Api::PeerColors> _peerColors;
+	const std::unique_ptr<Api::PollScheduler> _pollScheduler;
 
 	mtpRequestId _wallPaperRequestId = 0;
 	QString _wallPaperSlug;
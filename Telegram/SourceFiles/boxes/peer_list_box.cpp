@@ -1106,8 +1106,9 @@ void PeerListContent::addToSearchIndex(not_null<PeerListRow*> row) {
 	removeFromSearchIndex(row);
 	row->setNameFirstLetters(row->generateNameFirstLetters());
 	for (auto ch : row->nameFirstLetters()) {
-		_searchIndex[ch].push_back(row);
+		_searchIndex[ch].rows.push_back(row);
 	}
+	_searchLocalWords.clear();
 }
 
 void PeerListContent::removeFromSearchIndex(not_null<PeerListRow*> row) {
@@ -1116,7 +1117,7 @@ void PeerListContent::removeFromSearchIndex(not_null<PeerListRow*> row) {
 		for (auto ch : row->nameFirstLetters()) {
 			auto it = _searchIndex.find(ch);
 			if (it != _searchIndex.cend()) {
-				auto &entry = it->second;
+				auto &entry = it->second.rows;
 				entry.erase(ranges::remove(entry, row), end(entry));
 				if (entry.empty()) {
 					_searchIndex.erase(it);
@@ -1124,6 +1125,7 @@ void PeerListContent::removeFromSearchIndex(not_null<PeerListRow*> row) {
 			}
 		}
 		row->setNameFirstLetters({});
+		_searchLocalWords.clear();
 	}
 }
 
@@ -1244,6 +1246,8 @@ void PeerListContent::clearAllContent() {
 	_rowsByPeer.clear();
 	_filterResults.clear();
 	_searchIndex.clear();
+	_searchLocalWords.clear();
+	_searchLocalResults.clear();
 	_rows.clear();
 	_searchRows.clear();
 	_searchQuery
@@ -2037,46 +2041,77 @@ void PeerListContent::searchQueryChanged(QString query) {
 		if (_controller->searchInLocal() && !searchWordsList.isEmpty()) {
 			Assert(_hiddenRows.empty());
 
-			auto minimalList = (const std::vector<not_null<PeerListRow*>>*)nullptr;
+			// When every previous word is a prefix of some new word
+			// (the user keeps typing) the new results can only be a part
+			// of the previous ones, so there is no need to go to the index.
+			const auto refined = !_searchLocalWords.isEmpty()
+				&& ranges::all_of(_searchLocalWords, [&](
+						const QString &was) {
+					return ranges::any_of(searchWordsList, [&](
+							const QString &now) {
+						return now.startsWith(was);
+					});
+				});
+			auto minimalList = refined
+				? &_searchLocalResults
+				: (std::vector<not_null<PeerListRow*>>*)nullptr;
+			auto minimalEntry = (SearchIndexEntry*)nullptr;
 			for (const auto &searchWord : searchWordsList) {
-				auto searchWordStart = searchWord[0].toLower();
+				if (refined) {
+					break;
+				}
+				const auto searchWordStart = searchWord[0].toLower();
 				auto it = _searchIndex.find(searchWordStart);
-				if (it == _searchIndex.cend()) {
+				if (it == _searchIndex.end()) {
 					// Some word can't be found in any row.
-					minimalList = nullptr;
+					minimalEntry = nullptr;
 					break;
-				} else if (!minimalList || minimalList->size() > it->second.size()) {
-					minimalList = &it->second;
+				} else if (!minimalEntry
+					|| minimalEntry->rows.size() > it->second.rows.size()) {
+					minimalEntry = &it->second;
+				}
+			}
+			if (minimalEntry) {
+				// Entries are sorted lazily after the rows were reordered.
+				if (!minimalEntry->sorted) {
+					ranges::sort(
+						minimalEntry->rows,
+						ranges::less(),
+						&PeerListRow::absoluteIndex);
+					minimalEntry->sorted = true;
 				}
+				minimalList = &minimalEntry->rows;
 			}
+			auto results = std::vector<not_null<PeerListRow*>>();
 			if (minimalList) {
-				auto searchWordInNames = [](
-						not_null<PeerListRow*> row,
-						const QString &searchWord) {
-					for (auto &nameWord : row->generateNameWords()) {
-						if (nameWord.startsWith(searchWord)) {
-							return true;
-						}
-					}
-					return false;
-				};
 				auto allSearchWordsInNames = [&](
 						not_null<PeerListRow*> row) {
+					const auto &nameWords = row->generateNameWords();
 					for (const auto &searchWord : searchWordsList) {
-						if (!searchWordInNames(row, searchWord)) {
+						const auto found = ranges::any_of(nameWords, [&](
+								const QString &nameWord) {
+							return nameWord.startsWith(searchWord);
+						});
+						if (!found) {
 							return false;
 						}
 					}
 					return true;
 				};
 
-				_filterResults.reserve(minimalList->size());
+				results.reserve(minimalList->size());
 				for (const auto &row : *minimalList) {
 					if (allSearchWordsInNames(row)) {
-						_filterResults.push_back(row);
+						results.push_back(row);
 					}
 				}
 			}
+			_filterResults = results;
+			_searchLocalWords = searchWordsList;
+			_searchLocalResults = std::move(results);
+		} else {
+			_searchLocalWords.clear();
+			_searchLocalResults.clear();
 		}
 		if (_controller->hasComplexSearch()) {
 			_controller->search(_searchQuery);
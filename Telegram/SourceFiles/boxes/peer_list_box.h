@@ -682,9 +682,10 @@ public:
 	template <typename ReorderCallback>
 	void reorderRows(ReorderCallback &&callback) {
 		callback(_rows.begin(), _rows.end());
-		for (auto &searchEntity : _searchIndex) {
-			callback(searchEntity.second.begin(), searchEntity.second.end());
+		for (auto &[letter, entry] : _searchIndex) {
+			entry.sorted = false;
 		}
+		_searchLocalWords.clear();
 		refreshIndices();
 		if (!_hiddenRows.empty()) {
 			callback(_filterResults.begin(), _filterResults.end());
@@ -851,7 +852,13 @@ private:
 	std::map<PeerListRowId, not_null<PeerListRow*>> _rowsById;
 	std::map<PeerData*, std::vector<not_null<PeerListRow*>>> _rowsByPeer;
 
-	std::map<QChar, std::vector<not_null<PeerListRow*>>> _searchIndex;
+	struct SearchIndexEntry {
+		std::vector<not_null<PeerListRow*>> rows;
+		bool sorted = true;
+	};
+	std::map<QChar, SearchIndexEntry> _searchIndex;
+	QStringList _searchLocalWords;
+	std::vector<not_null<PeerListRow*>> _searchLocalResults;
 	QString _searchQuery;
 	QString _normalizedSearchQuery;
 	QString _mentionHighlight;
@@ -46,6 +46,7 @@ constexpr auto kMaxInvitePerSlice = 10;
 constexpr auto kCheckLastSpokeInterval = crl::time(1000);
 constexpr auto kCheckJoinedTimeout = 4 * crl::time(1000);
 constexpr auto kUpdateSendActionEach = crl::time(500);
+constexpr auto kApplyLevelsInterval = crl::time(16);
 constexpr auto kPlayConnectingEach = crl::time(1056) + 2 * crl::time(1000);
 constexpr auto kFixManualLargeVideoDuration = 5 * crl::time(1000);
 constexpr auto kFixSpeakingLargeVideoDuration = 3 * crl::time(1000);
@@ -217,6 +218,46 @@ private:
 
 };
 
+class GroupCall::LevelsBuffer final {
+public:
+	struct Level {
+		float level = 0.f;
+		bool voice = false;
+		bool spoke = false;
+		bool spokeVoice = false;
+	};
+	using Levels = base::flat_map<uint32, Level>;
+
+	// Returns true if the main thread should be asked to take the levels.
+	[[nodiscard]] bool add(const tgcalls::GroupLevelsUpdate &data);
+	[[nodiscard]] Levels take();
+
+private:
+	Levels _levels;
+	bool _scheduled = false;
+	QMutex _mutex;
+
+};
+
+bool GroupCall::LevelsBuffer::add(const tgcalls::GroupLevelsUpdate &data) {
+	QMutexLocker lock(&_mutex);
+	for (const auto &[ssrc, value] : data.updates) {
+		auto &level = _levels[ssrc];
+		const auto spoke = (value.level > kSpeakLevelThreshold);
+		level.level = value.level;
+		level.voice = value.voice;
+		level.spoke = level.spoke || spoke;
+		level.spokeVoice = level.spokeVoice || (spoke && value.voice);
+	}
+	return !std::exchange(_scheduled, true);
+}
+
+auto GroupCall::LevelsBuffer::take() -> Levels {
+	QMutexLocker lock(&_mutex);
+	_scheduled = false;
+	return base::take(_levels);
+}
+
 struct GroupCall::SinkPointer {
 	std::weak_ptr<Webrtc::SinkInterface> data;
 };
@@ -582,6 +623,8 @@ GroupCall::GroupCall(
 , _scheduleDate(info.scheduleDate)
 , _lastSpokeCheckTimer([=] { checkLastSpoke(); })
 , _checkJoinedTimer([=] { checkJoined(); })
+, _levelsBuffer(std::make_shared<LevelsBuffer>())
+, _applyLevelsTimer([=] { applyPendingLevels(); })
 , _playbackDeviceId(
 	&Core::App().mediaDevices(),
 	Webrtc::DeviceType::Playback,
@@ -2376,6 +2419,7 @@ bool GroupCall::tryCreateController() {
 
 	const auto weak = base::make_weak(&_instanceGuard);
 	const auto myLevel = std::make_shared<tgcalls::GroupLevelValue>();
+	const auto levelsBuffer = _levelsBuffer;
 	const auto playbackDeviceIdInitial = _playbackDeviceId.current();
 	const auto captureDeviceIdInitial = _captureDeviceId.current();
 	const auto saveSetDeviceIdCallback = [=](
@@ -2422,7 +2466,9 @@ bool GroupCall::tryCreateController() {
 				}
 				*myLevel = updates.front().value;
 			}
-			crl::on_main(weak, [=] { audioLevelsUpdated(data); });
+			if (levelsBuffer->add(data)) {
+				crl::on_main(weak, [=] { applyPendingLevels(); });
+			}
 		},
 		.initialInputDeviceId = captureDeviceIdInitial.value.toStdString(),
 		.initialOutputDeviceId = playbackDeviceIdInitial.value.toStdString(),
@@ -2997,35 +3043,42 @@ void GroupCall::updateInstanceVolume(
 	}
 }
 
-void GroupCall::audioLevelsUpdated(const tgcalls::GroupLevelsUpdate &data) {
-	Expects(!data.updates.empty());
+void GroupCall::applyPendingLevels() {
+	// Levels arrive from the call thread much more often than the screen
+	// is refreshed, so they are applied at most once in a display frame.
+	const auto now = crl::now();
+	const auto next = _levelsApplied + kApplyLevelsInterval;
+	if (next > now) {
+		_applyLevelsTimer.callOnce(next - now);
+		return;
+	}
+	_levelsApplied = now;
+	const auto levels = _levelsBuffer->take();
 
 	auto check = false;
 	auto checkNow = false;
-	const auto now = crl::now();
 	const auto meMuted = [&] {
 		const auto state = muted();
 		return (state != MuteState::Active)
 			&& (state != MuteState::PushToTalk);
 	};
-	for (const auto &[ssrcOrZero, value] : data.updates) {
+	for (const auto &[ssrcOrZero, value] : levels) {
 		const auto ssrc = ssrcOrZero ? ssrcOrZero : _joinState.ssrc;
 		if (!ssrc) {
 			continue;
 		}
-		const auto level = value.level;
-		const auto voice = value.voice;
 		const auto me = (ssrc == _joinState.ssrc);
 		const auto ignore = me && meMuted();
 		_levelUpdates.fire(LevelUpdate{
 			.ssrc = ssrc,
-			.value = ignore ? 0.f : level,
-			.voice = (!ignore && voice),
+			.value = ignore ? 0.f : value.level,
+			.voice = (!ignore && value.voice),
 			.me = me,
 		});
-		if (level <= kSpeakLevelThreshold) {
+		if (!value.spoke) {
 			continue;
 		}
+		const auto voice = value.spokeVoice;
 		if (me
 			&& voice
 			&& (!_lastSendProgressUpdate
@@ -424,6 +424,7 @@ private:
 	using GlobalShortcutValue = base::GlobalShortcutValue;
 	using Error = Group::Error;
 	struct SinkPointer;
+	class LevelsBuffer;
 
 	static constexpr uint32 kDisabledSsrc = uint32(-1);
 
@@ -519,7 +520,7 @@ private:
 	void leavePresentation();
 	void checkNextJoinAction();
 
-	void audioLevelsUpdated(const tgcalls::GroupLevelsUpdate &data);
+	void applyPendingLevels();
 	void setInstanceConnected(tgcalls::GroupNetworkState networkState);
 	void setInstanceMode(InstanceMode mode);
 	void setScreenInstanceConnected(tgcalls::GroupNetworkState networkState);
@@ -670,6 +671,9 @@ private:
 	rpl::event_stream<> _titleChanged;
 	base::Timer _lastSpokeCheckTimer;
 	base::Timer _checkJoinedTimer;
+	const std::shared_ptr<LevelsBuffer> _levelsBuffer;
+	base::Timer _applyLevelsTimer;
+	crl::time _levelsApplied = 0;
 
 	crl::time _lastSendProgressUpdate = 0;
 
@@ -44,6 +44,17 @@ struct LangPackData {
 	std::map<QString, std::vector<LangPackEmoji>> emoji;
 };
 
+// Immutable flattened copy of LangPackData::emoji used for lookups.
+// Keys are sorted, so a prefix query is a binary search followed by
+// a forward scan over contiguous storage, without any allocations.
+struct LangPackIndex {
+	int version = 0;
+	int maxKeyLength = 0;
+	std::vector<QString> keys;
+	std::vector<int> offsets; // keys.size() + 1 offsets in 'emoji'.
+	std::vector<LangPackEmoji> emoji;
+};
+
 [[nodiscard]] bool MustAddPostfix(const QString &text) {
 	if (text.size() != 1) {
 		return false;
@@ -165,6 +176,41 @@ void WriteLocalCache(const QString &id, const LangPackData &data) {
 	}
 }
 
+[[nodiscard]] LangPackIndex BuildIndex(const LangPackData &data) {
+	auto result = LangPackIndex();
+	result.version = data.version;
+	result.maxKeyLength = data.maxKeyLength;
+	result.keys.reserve(data.emoji.size());
+	result.offsets.reserve(data.emoji.size() + 1);
+	auto total = 0;
+	for (const auto &[key, list] : data.emoji) {
+		total += int(list.size());
+	}
+	result.emoji.reserve(total);
+	for (const auto &[key, list] : data.emoji) {
+		result.keys.push_back(key);
+		result.offsets.push_back(int(result.emoji.size()));
+		result.emoji.insert(end(result.emoji), begin(list), end(list));
+	}
+	result.offsets.push_back(int(result.emoji.size()));
+	return result;
+}
+
+[[nodiscard]] LangPackData RestoreData(const LangPackIndex &index) {
+	auto result = LangPackData();
+	result.version = index.version;
+	result.maxKeyLength = index.maxKeyLength;
+	for (auto i = 0, count = int(index.keys.size()); i != count; ++i) {
+		const auto from = begin(index.emoji) + index.offsets[i];
+		const auto till = begin(index.emoji) + index.offsets[i + 1];
+		result.emoji.emplace_hint(
+			end(result.emoji),
+			index.keys[i],
+			std::vector<LangPackEmoji>(from, till));
+	}
+	return result;
+}
+
 [[nodiscard]] QString NormalizeQuery(const QString &query) {
 	return query.toLower();
 }
@@ -176,7 +222,7 @@ void WriteLocalCache(const QString &id, const LangPackData &data) {
 void AppendFoundEmoji(
 		std::vector<Result> &result,
 		const QString &label,
-		const std::vector<LangPackEmoji> &list) {
+		std::span<const LangPackEmoji> list) {
 	// It is important that the 'result' won't relocate while inserting.
 	result.reserve(result.size() + list.size());
 	const auto alreadyBegin = begin(result);
@@ -319,7 +365,9 @@ public:
 	void refresh();
 	void apiChanged();
 
-	[[nodiscard]] std::vector<Result> query(
+	// Appends found emoji to 'result', skipping already present ones.
+	void query(
+		std::vector<Result> &result,
 		const QString &normalized,
 		bool exact) const;
 	[[nodiscard]] int maxQueryLength() const;
@@ -334,12 +382,12 @@ private:
 
 	void readLocalCache();
 	void applyDifference(const MTPEmojiKeywordsDifference &result);
-	void applyData(LangPackData &&data);
+	void applyData(LangPackIndex &&data);
 
 	not_null<Delegate*> _delegate;
 	QString _id;
 	State _state = State::ReadingCache;
-	LangPackData _data;
+	LangPackIndex _data;
 	crl::time _lastRefreshTime = 0;
 	mtpRequestId _requestId = 0;
 	base::binary_guard _guard;
@@ -365,14 +413,14 @@ EmojiKeywords::LangPack::~LangPack() {
 void EmojiKeywords::LangPack::readLocalCache() {
 	const auto id = _id;
 	auto callback = crl::guard(_guard.make_guard(), [=](
-			LangPackData &&result) {
+			LangPackIndex &&result) {
 		applyData(std::move(result));
 		refresh();
 	});
 	crl::async([id, callback = std::move(callback)]() mutable {
 		crl::on_main([
 			callback = std::move(callback),
-			result = ReadLocalCache(id)
+			result = BuildIndex(ReadLocalCache(id))
 		]() mutable {
 			callback(std::move(result));
 		});
@@ -436,16 +484,17 @@ void EmojiKeywords::LangPack::applyDifference(
 		const auto id = _id;
 		auto copy = _data;
 		auto callback = crl::guard(_guard.make_guard(), [=](
-				LangPackData &&result) {
+				LangPackIndex &&result) {
 			applyData(std::move(result));
 		});
 		crl::async([=,
 			copy = std::move(copy),
 			callback = std::move(callback)]() mutable {
-			ApplyDifference(copy, keywords, version);
-			WriteLocalCache(id, copy);
+			auto data = RestoreData(copy);
+			ApplyDifference(data, keywords, version);
+			WriteLocalCache(id, data);
 			crl::on_main([
-				result = std::move(copy),
+				result = BuildIndex(data),
 				callback = std::move(callback)
 			]() mutable {
 				callback(std::move(result));
@@ -454,7 +503,7 @@ void EmojiKeywords::LangPack::applyDifference(
 	});
 }
 
-void EmojiKeywords::LangPack::applyData(LangPackData &&data) {
+void EmojiKeywords::LangPack::applyData(LangPackIndex &&data) {
 	_data = std::move(data);
 	_state = State::Refreshed;
 	_delegate->langPackRefreshed();
@@ -470,29 +519,30 @@ void EmojiKeywords::LangPack::apiChanged() {
 	refresh();
 }
 
-std::vector<Result> EmojiKeywords::LangPack::query(
+void EmojiKeywords::LangPack::query(
+		std::vector<Result> &result,
 		const QString &normalized,
 		bool exact) const {
 	if (normalized.size() > _data.maxKeyLength
-		|| _data.emoji.empty()
+		|| _data.keys.empty()
 		|| (exact && SkipExactKeyword(_id, normalized))) {
-		return {};
+		return;
 	}
 
-	const auto from = _data.emoji.lower_bound(normalized);
-	auto &&chosen = ranges::make_subrange(
-		from,
-		end(_data.emoji)
-	) | ranges::views::take_while([&](const auto &pair) {
-		const auto &key = pair.first;
-		return exact ? (key == normalized) : key.startsWith(normalized);
-	});
-
-	auto result = std::vector<Result>();
-	for (const auto &[key, list] : chosen) {
-		AppendFoundEmoji(result, key, list);
+	const auto keysBegin = begin(_data.keys);
+	const auto keysEnd = end(_data.keys);
+	const auto emoji = std::span<const LangPackEmoji>(_data.emoji);
+	const auto from = std::lower_bound(keysBegin, keysEnd, normalized);
+	for (auto i = from; i != keysEnd; ++i) {
+		const auto &key = *i;
+		if (exact ? (key != normalized) : !key.startsWith(normalized)) {
+			break;
+		}
+		const auto index = int(i - keysBegin);
+		const auto offset = _data.offsets[index];
+		const auto count = _data.offsets[index + 1] - offset;
+		AppendFoundEmoji(result, key, emoji.subspan(offset, count));
 	}
-	return result;
 }
 
 int EmojiKeywords::LangPack::maxQueryLength() const {
@@ -614,26 +664,9 @@ std::vector<Result> EmojiKeywords::query(
 	}
 	auto result = std::vector<Result>();
 	for (const auto &[language, item] : _data) {
-		const auto list = item->query(normalized, exact);
-
-		// It is important that the 'result' won't relocate while inserting.
-		result.reserve(result.size() + list.size());
-		const auto alreadyBegin = begin(result);
-		const auto alreadyEnd = alreadyBegin + result.size();
-
-		auto &&add = ranges::views::all(
-			list
-		) | ranges::views::filter([&](Result entry) {
-			// In each item->query() result the list has no duplicates.
-			// So we need to check only for duplicates between queries.
-			const auto i = ranges::find(
-				alreadyBegin,
-				alreadyEnd,
-				entry.emoji,
-				&Result::emoji);
-			return (i == alreadyEnd);
-		});
-		result.insert(end(result), add.begin(), add.end());
+		// Each pack appends right into the merged list, skipping emoji
+		// already found in it, so no intermediate lists are allocated.
+		item->query(result, normalized, exact);
 	}
 	if (!exact) {
 		AppendLegacySuggestions(result, query);
@@ -243,8 +243,64 @@ const GroupCallParticipant *GroupCall::participantByPeer(
 
 GroupCallParticipant *GroupCall::findParticipant(
 		not_null<PeerData*> peer) {
-	const auto i = ranges::find(_participants, peer, &Participant::peer);
-	return (i != end(_participants)) ? &*i : nullptr;
+	const auto i = _participantIndexByPeer.find(peer->id);
+	return (i != end(_participantIndexByPeer))
+		? &_participants[i->second]
+		: nullptr;
+}
+
+void GroupCall::addParticipantIndexes(const Participant &participant) {
+	const auto peer = participant.peer;
+	if (participant.ssrc) {
+		_participantPeerByAudioSsrc.emplace(participant.ssrc, peer);
+	}
+	const auto &params = participant.videoParams;
+	if (const auto additional = GetAdditionalAudioSsrc(params)) {
+		_participantPeerByAudioSsrc.emplace(additional, peer);
+	}
+	for (const auto &endpoint : {
+		GetCameraEndpoint(params),
+		GetScreenEndpoint(params),
+	}) {
+		if (!endpoint.empty()) {
+			_participantPeerByEndpoint.emplace(endpoint, peer);
+		}
+	}
+}
+
+void GroupCall::removeParticipantIndexes(const Participant &participant) {
+	const auto peer = participant.peer;
+	const auto remove = [&](auto &map, const auto &key) {
+		const auto i = map.find(key);
+		if (i != end(map) && i->second == peer) {
+			map.erase(i);
+		}
+	};
+	const auto &params = participant.videoParams;
+	remove(_participantPeerByAudioSsrc, participant.ssrc);
+	remove(_participantPeerByAudioSsrc, GetAdditionalAudioSsrc(params));
+	remove(_participantPeerByEndpoint, GetCameraEndpoint(params));
+	remove(_participantPeerByEndpoint, GetScreenEndpoint(params));
+}
+
+void GroupCall::eraseParticipant(not_null<PeerData*> peer) {
+	const auto i = _participantIndexByPeer.find(peer->id);
+	Assert(i != end(_participantIndexByPeer));
+
+	const auto index = i->second;
+	_participantIndexByPeer.erase(i);
+	removeParticipantIndexes(_participants[index]);
+	_participants.erase(begin(_participants) + index);
+	for (auto j = index, count = int(_participants.size()); j != count; ++j) {
+		_participantIndexByPeer[_participants[j].peer->id] = j;
+	}
+}
+
+void GroupCall::clearParticipants() {
+	_participants.clear();
+	_participantIndexByPeer.clear();
+	_participantPeerByAudioSsrc.clear();
+	_participantPeerByEndpoint.clear();
 }
 
 const GroupCallParticipant *GroupCall::participantByEndpoint(
@@ -252,13 +308,10 @@ const GroupCallParticipant *GroupCall::participantByEndpoint(
 	if (endpoint.empty()) {
 		return nullptr;
 	}
-	for (const auto &participant : _participants) {
-		if (GetCameraEndpoint(participant.videoParams) == endpoint
-			|| GetScreenEndpoint(participant.videoParams) == endpoint) {
-			return &participant;
-		}
-	}
-	return nullptr;
+	const auto i = _participantPeerByEndpoint.find(endpoint);
+	return (i != end(_participantPeerByEndpoint))
+		? participantByPeer(i->second)
+		: nullptr;
 }
 
 rpl::producer<> GroupCall::participantsReloaded() {
@@ -368,9 +421,8 @@ void GroupCall::processFullCallFields(const MTPphone_GroupCall &call) {
 		const auto &participants = data.vparticipants().v;
 		const auto nextOffset = qs(data.vparticipants_next_offset());
 		data.vcall().match([&](const MTPDgroupCall &data) {
-			_participants.clear();
+			clearParticipants();
 			_speakingByActiveFinishes.clear();
-			_participantPeerByAudioSsrc.clear();
 			_allParticipantsLoaded = false;
 
 			applyParticipantsSlice(
@@ -567,20 +619,14 @@ void GroupCall::applyParticipantsSlice(
 			const auto participantPeerId = peerFromMTP(data.vpeer());
 			const auto participantPeer = _peer->owner().peer(
 				participantPeerId);
-			const auto i = ranges::find(
-				_participants,
-				participantPeer,
-				&Participant::peer);
+			const auto i = findParticipant(participantPeer);
 			if (data.is_left()) {
-				if (i != end(_participants)) {
+				if (i) {
 					auto update = ParticipantUpdate{
 						.was = *i,
 					};
-					_participantPeerByAudioSsrc.erase(i->ssrc);
-					_participantPeerByAudioSsrc.erase(
-						GetAdditionalAudioSsrc(i->videoParams));
 					_speakingByActiveFinishes.remove(participantPeer);
-					_participants.erase(i);
+					eraseParticipant(participantPeer);
 					if (sliceSource != ApplySliceSource::FullReloaded) {
 						_participantUpdates.fire(std::move(update));
 					}
@@ -593,7 +639,7 @@ void GroupCall::applyParticipantsSlice(
 			if (const auto about = data.vabout()) {
 				participantPeer->setAbout(qs(*about));
 			}
-			const auto was = (i != end(_participants))
+			const auto was = i
 				? std::make_optional(*i)
 				: std::nullopt;
 			const auto canSelfUnmute = !data.is_muted()
@@ -618,7 +664,7 @@ void GroupCall::applyParticipantsSlice(
 				= data.vraise_hand_rating().value_or_empty();
 			const auto localUpdate = (sliceSource
 				== ApplySliceSource::UpdateConstructed);
-			const auto existingVideoParams = (i != end(_participants))
+			const auto existingVideoParams = i
 				? i->videoParams
 				: nullptr;
 			auto videoParams = localUpdate
@@ -650,43 +696,19 @@ void GroupCall::applyParticipantsSlice(
 				.videoJoined = videoJoined,
 				.applyVolumeFromMin = applyVolumeFromMin,
 			};
-			if (i == end(_participants)) {
-				if (value.ssrc) {
-					_participantPeerByAudioSsrc.emplace(
-						value.ssrc,
-						participantPeer);
-				}
-				if (const auto additional = GetAdditionalAudioSsrc(
-						value.videoParams)) {
-					_participantPeerByAudioSsrc.emplace(
-						additional,
-						participantPeer);
-				}
+			if (!i) {
+				_participantIndexByPeer.emplace(
+					participantPeer->id,
+					int(_participants.size()));
 				_participants.push_back(value);
+				addParticipantIndexes(value);
 				if (const auto user = participantPeer->asUser()) {
 					_peer->owner().unregisterInvitedToCallUser(_id, user);
 				}
 			} else {
-				if (i->ssrc != value.ssrc) {
-					_participantPeerByAudioSsrc.erase(i->ssrc);
-					if (value.ssrc) {
-						_participantPeerByAudioSsrc.emplace(
-							value.ssrc,
-							participantPeer);
-					}
-				}
-				if (GetAdditionalAudioSsrc(i->videoParams)
-					!= GetAdditionalAudioSsrc(value.videoParams)) {
-					_participantPeerByAudioSsrc.erase(
-						GetAdditionalAudioSsrc(i->videoParams));
-					if (const auto additional = GetAdditionalAudioSsrc(
-						value.videoParams)) {
-						_participantPeerByAudioSsrc.emplace(
-							additional,
-							participantPeer);
-					}
-				}
+				removeParticipantIndexes(*i);
 				*i = value;
+				addParticipantIndexes(*i);
 			}
 			if (data.is_just_joined()) {
 				++_serverParticipantsCount;
@@ -914,11 +936,7 @@ void GroupCall::requestUnknownParticipants() {
 		}
 		for (const auto &[id, when] : participantPeerIds) {
 			if (const auto participantPeer = _peer->owner().peerLoaded(id)) {
-				const auto isParticipant = ranges::contains(
-					_participants,
-					not_null{ participantPeer },
-					&Participant::peer);
-				if (isParticipant) {
+				if (findParticipant(participantPeer)) {
 					applyActiveUpdate(id, when, participantPeer);
 				}
 			}
@@ -199,6 +199,10 @@ private:
 	[[nodiscard]] bool processSavedFullCall();
 	void finishParticipantsSliceRequest();
 	[[nodiscard]] Participant *findParticipant(not_null<PeerData*> peer);
+	void addParticipantIndexes(const Participant &participant);
+	void removeParticipantIndexes(const Participant &participant);
+	void eraseParticipant(not_null<PeerData*> peer);
+	void clearParticipants();
 
 	const CallId _id = 0;
 	const CallId _accessHash = 0;
@@ -217,7 +221,11 @@ private:
 	std::optional<MTPphone_GroupCall> _savedFull;
 
 	std::vector<Participant> _participants;
-	base::flat_map<uint32, not_null<PeerData*>> _participantPeerByAudioSsrc;
+	std::unordered_map<PeerId, int> _participantIndexByPeer;
+	std::unordered_map<uint32, not_null<PeerData*>> _participantPeerByAudioSsrc;
+	std::unordered_map<
+		std::string,
+		not_null<PeerData*>> _participantPeerByEndpoint;
 	base::flat_map<not_null<PeerData*>, crl::time> _speakingByActiveFinishes;
 	base::Timer _speakingByActiveFinishTimer;
 	QString _nextOffset;
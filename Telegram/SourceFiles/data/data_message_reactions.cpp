@@ -33,6 +33,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/timer_rpl.h"
 #include "base/call_delayed.h"
 #include "base/unixtime.h"
+#include "api/api_poll_scheduler.h"
 #include "apiwrap.h"
 #include "styles/style_chat.h"
 
@@ -340,7 +341,9 @@ Reactions::Reactions(not_null<Session*> owner)
 	});
 }
 
-Reactions::~Reactions() = default;
+Reactions::~Reactions() {
+	session().api().pollScheduler().cancel(&_repaintTimer);
+}
 
 Main::Session &Reactions::session() const {
 	return _owner->session();
@@ -1462,7 +1465,9 @@ void Reactions::poll(not_null<HistoryItem*> item, crl::time now) {
 			_repaintItems.emplace(item, grouped + kPollEach);
 			if (!_repaintTimer.isActive()
 				|| _repaintTimer.remainingTime() > left) {
-				_repaintTimer.callOnce(left);
+				session().api().pollScheduler().callOnce(
+					&_repaintTimer,
+					left);
 			}
 		}
 	} else if (!_pollingItems.contains(item)) {
@@ -1612,7 +1617,9 @@ void Reactions::repaintCollected() {
 		}
 	}
 	if (closest) {
-		_repaintTimer.callOnce(closest - now);
+		session().api().pollScheduler().callOnce(
+			&_repaintTimer,
+			closest - now);
 	}
 }
 
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "dialogs/dialogs_main_list.h"
 #include "data/data_groups.h"
 #include "data/data_cloud_file.h"
+#include "data/data_small_flat_set.h"
 #include "history/history_location_manager.h"
 #include "base/timer.h"
 
@@ -951,9 +952,9 @@ private:
 
 	MsgId _localMessageIdCounter = StartClientMsgId;
 	std::unordered_map<PeerId, Messages> _messages;
-	std::map<
+	std::unordered_map<
 		not_null<HistoryItem*>,
-		base::flat_set<not_null<HistoryItem*>>> _dependentMessages;
+		SmallFlatSet<not_null<HistoryItem*>>> _dependentMessages;
 	std::map<TimeId, base::flat_set<not_null<HistoryItem*>>> _ttlMessages;
 	base::Timer _ttlCheckTimer;
 
@@ -970,22 +971,22 @@ private:
 		std::unique_ptr<PhotoData>> _photos;
 	std::unordered_map<
 		not_null<const PhotoData*>,
-		base::flat_set<not_null<HistoryItem*>>> _photoItems;
+		SmallFlatSet<not_null<HistoryItem*>>> _photoItems;
 	std::unordered_map<
 		DocumentId,
 		std::unique_ptr<DocumentData>> _documents;
 	std::unordered_map<
 		not_null<const DocumentData*>,
-		base::flat_set<not_null<HistoryItem*>>> _documentItems;
+		SmallFlatSet<not_null<HistoryItem*>>> _documentItems;
 	std::unordered_map<
 		WebPageId,
 		std::unique_ptr<WebPageData>> _webpages;
 	std::unordered_map<
 		not_null<const WebPageData*>,
-		base::flat_set<not_null<HistoryItem*>>> _webpageItems;
+		SmallFlatSet<not_null<HistoryItem*>>> _webpageItems;
 	std::unordered_map<
 		not_null<const WebPageData*>,
-		base::flat_set<not_null<ViewElement*>>> _webpageViews;
+		SmallFlatSet<not_null<ViewElement*>>> _webpageViews;
 	std::unordered_map<
 		LocationPoint,
 		std::unique_ptr<CloudImage>> _locations;
@@ -1000,20 +1001,20 @@ private:
 		std::unique_ptr<BotAppData>> _botApps;
 	std::unordered_map<
 		not_null<const GameData*>,
-		base::flat_set<not_null<ViewElement*>>> _gameViews;
+		SmallFlatSet<not_null<ViewElement*>>> _gameViews;
 	std::unordered_map<
 		not_null<const PollData*>,
-		base::flat_set<not_null<ViewElement*>>> _pollViews;
+		SmallFlatSet<not_null<ViewElement*>>> _pollViews;
 	std::unordered_map<
 		UserId,
-		base::flat_set<not_null<HistoryItem*>>> _contactItems;
+		SmallFlatSet<not_null<HistoryItem*>>> _contactItems;
 	std::unordered_map<
 		UserId,
-		base::flat_set<not_null<ViewElement*>>> _contactViews;
+		SmallFlatSet<not_null<ViewElement*>>> _contactViews;
 	std::unordered_set<not_null<HistoryItem*>> _callItems;
 	std::unordered_map<
 		FullStoryId,
-		base::flat_set<not_null<HistoryItem*>>> _storyItems;
+		SmallFlatSet<not_null<HistoryItem*>>> _storyItems;
 	base::flat_map<uint64, not_null<HistoryItem*>> _highlightings;
 	base::flat_map<QString, not_null<DocumentData*>> _venueIcons;
 
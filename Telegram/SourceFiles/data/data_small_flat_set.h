@@ -0,0 +1,111 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Data {
+
+// Sorted set of small trivially copyable values (pointers, ids)
+// that keeps a single value inline, without a heap allocation.
+//
+// Used for the reverse indexes in Data::Session (photo -> items,
+// document -> items, etc.), where almost every key has one value.
+template <typename Value>
+class SmallFlatSet final {
+public:
+	using value_type = Value;
+	using const_iterator = const Value*;
+
+	SmallFlatSet() = default;
+	SmallFlatSet(const SmallFlatSet &other) = default;
+	SmallFlatSet &operator=(const SmallFlatSet &other) = default;
+	SmallFlatSet(SmallFlatSet &&other) noexcept
+	: _single(base::take(other._single))
+	, _many(base::take(other._many)) {
+	}
+	SmallFlatSet &operator=(SmallFlatSet &&other) noexcept {
+		_single = base::take(other._single);
+		_many = base::take(other._many);
+		return *this;
+	}
+
+	[[nodiscard]] const_iterator begin() const {
+		return _single ? &*_single : _many.data();
+	}
+	[[nodiscard]] const_iterator end() const {
+		return _single ? (&*_single + 1) : (_many.data() + _many.size());
+	}
+	[[nodiscard]] int size() const {
+		return _single ? 1 : int(_many.size());
+	}
+	[[nodiscard]] bool empty() const {
+		return !_single && _many.empty();
+	}
+	[[nodiscard]] bool contains(const Value &value) const {
+		return _single
+			? (*_single == value)
+			: std::binary_search(_many.begin(), _many.end(), value);
+	}
+
+	bool insert(const Value &value) {
+		if (empty()) {
+			_single = value;
+			return true;
+		} else if (_single) {
+			if (*_single == value) {
+				return false;
+			}
+			_many.reserve(2);
+			_many.push_back(*base::take(_single));
+		}
+		const auto i = std::lower_bound(_many.begin(), _many.end(), value);
+		if (i != _many.end() && *i == value) {
+			return false;
+		}
+		_many.insert(i, value);
+		return true;
+	}
+	bool emplace(const Value &value) {
+		return insert(value);
+	}
+	bool remove(const Value &value) {
+		if (_single) {
+			if (*_single != value) {
+				return false;
+			}
+			_single = std::nullopt;
+			return true;
+		}
+		const auto i = std::lower_bound(_many.begin(), _many.end(), value);
+		if (i == _many.end() || *i != value) {
+			return false;
+		}
+		_many.erase(i);
+		if (_many.size() == 1) {
+			_single = _many.front();
+			_many = std::vector<Value>();
+		}
+		return true;
+	}
+
+private:
+	std::optional<Value> _single;
+	std::vector<Value> _many;
+
+};
+
+template <typename Value>
+[[nodiscard]] inline auto begin(const SmallFlatSet<Value> &set) {
+	return set.begin();
+}
+
+template <typename Value>
+[[nodiscard]] inline auto end(const SmallFlatSet<Value> &set) {
+	return set.end();
+}
+
+} // namespace Data
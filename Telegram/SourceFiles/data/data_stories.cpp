@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "data/data_stories.h"
 
+#include "api/api_poll_scheduler.h"
 #include "api/api_report.h"
 #include "base/unixtime.h"
 #include "apiwrap.h"
@@ -40,6 +41,7 @@ constexpr auto kSavedFirstPerPage = 30;
 constexpr auto kSavedPerPage = 100;
 constexpr auto kMaxPreloadSources = 10;
 constexpr auto kStillPreloadFromFirst = 3;
+constexpr auto kUrgentPreloadPriority = 1; // Same as of the playing video.
 constexpr auto kMaxSegmentsCount = 180;
 constexpr auto kPollingIntervalChat = 5 * TimeId(60);
 constexpr auto kPollingIntervalViewer = 1 * TimeId(60);
@@ -153,6 +155,10 @@ Stories::Stories(not_null<Session*> owner)
 Stories::~Stories() {
 	Expects(_pollingSettings.empty());
 	Expects(_pollingViews.empty());
+
+	auto &scheduler = _owner->session().api().pollScheduler();
+	scheduler.cancel(&_pollingTimer);
+	scheduler.cancel(&_pollingViewsTimer);
 }
 
 Session &Stories::owner() const {
@@ -1966,12 +1972,16 @@ void Stories::decrementPreloadingHiddenSources() {
 	}
 }
 
-void Stories::setPreloadingInViewer(std::vector<FullStoryId> ids) {
+void Stories::setPreloadingInViewer(
+		std::vector<FullStoryId> ids,
+		bool firstUrgent) {
 	ids.erase(ranges::remove_if(ids, [&](FullStoryId id) {
 		return _preloaded.contains(id);
 	}), end(ids));
-	if (_toPreloadViewer != ids) {
+	if (_toPreloadViewer != ids
+		|| _toPreloadViewerFirstUrgent != firstUrgent) {
 		_toPreloadViewer = std::move(ids);
+		_toPreloadViewerFirstUrgent = firstUrgent;
 		continuePreloading();
 	}
 }
@@ -2051,7 +2061,8 @@ void Stories::unregisterPolling(not_null<Story*> story, Polling polling) {
 		if (!--i->second.viewer) {
 			_pollingViews.remove(story);
 			if (_pollingViews.empty()) {
-				_pollingViewsTimer.cancel();
+				_owner->session().api().pollScheduler().cancel(
+					&_pollingViewsTimer);
 			}
 		}
 		break;
@@ -2092,7 +2103,9 @@ void Stories::maybeSchedulePolling(
 	const auto next = last + pollingInterval(settings);
 	const auto left = std::max(next - now, 0) * crl::time(1000) + 1;
 	if (!_pollingTimer.isActive() || _pollingTimer.remainingTime() > left) {
-		_pollingTimer.callOnce(left);
+		_owner->session().api().pollScheduler().callOnce(
+			&_pollingTimer,
+			left);
 	}
 }
 
@@ -2112,7 +2125,9 @@ void Stories::sendPollingRequests() {
 		}
 	}
 	if (min > 0) {
-		_pollingTimer.callOnce(min);
+		_owner->session().api().pollScheduler().callOnce(
+			&_pollingTimer,
+			min);
 	}
 }
 
@@ -2124,7 +2139,9 @@ void Stories::sendPollingViewsRequests() {
 		const auto story = _pollingViews.front();
 		loadViewsSlice(story->peer(), story->id(), QString(), nullptr);
 	}
-	_pollingViewsTimer.callOnce(kPollViewsInterval);
+	_owner->session().api().pollScheduler().callOnce(
+		&_pollingViewsTimer,
+		kPollViewsInterval);
 }
 
 void Stories::updatePeerStoriesState(not_null<PeerData*> peer) {
@@ -2186,6 +2203,7 @@ void Stories::continuePreloading() {
 	const auto now = _preloading ? _preloading->id() : FullStoryId();
 	if (now) {
 		if (shouldContinuePreload(now)) {
+			_preloading->setPriority(preloadPriority(now));
 			return;
 		}
 		_preloading = nullptr;
@@ -2222,11 +2240,20 @@ FullStoryId Stories::nextPreloadId() const {
 	return result;
 }
 
+int Stories::preloadPriority(FullStoryId id) const {
+	return (_toPreloadViewerFirstUrgent
+		&& !_toPreloadViewer.empty()
+		&& _toPreloadViewer.front() == id)
+		? kUrgentPreloadPriority
+		: 0;
+}
+
 void Stories::startPreloading(not_null<Story*> story) {
 	Expects(!_preloaded.contains(story->fullId()));
 
 	const auto id = story->fullId();
-	auto preloading = std::make_unique<StoryPreload>(story, [=] {
+	const auto priority = preloadPriority(id);
+	auto preloading = std::make_unique<StoryPreload>(story, priority, [=] {
 		_preloading = nullptr;
 		preloadFinished(id, true);
 	});
@@ -226,7 +226,9 @@ public:
 	void decrementPreloadingMainSources();
 	void incrementPreloadingHiddenSources();
 	void decrementPreloadingHiddenSources();
-	void setPreloadingInViewer(std::vector<FullStoryId> ids);
+	void setPreloadingInViewer(
+		std::vector<FullStoryId> ids,
+		bool firstUrgent = false);
 
 	struct PeerSourceState {
 		StoryId maxId = 0;
@@ -316,6 +318,7 @@ private:
 	void continuePreloading();
 	[[nodiscard]] bool shouldContinuePreload(FullStoryId id) const;
 	[[nodiscard]] FullStoryId nextPreloadId() const;
+	[[nodiscard]] int preloadPriority(FullStoryId id) const;
 	void startPreloading(not_null<Story*> story);
 	void preloadFinished(FullStoryId id, bool markAsPreloaded = false);
 	void preloadListsMore();
@@ -406,6 +409,7 @@ private:
 	base::flat_set<FullStoryId> _preloaded;
 	std::vector<FullStoryId> _toPreloadSources[kStorySourcesListCount];
 	std::vector<FullStoryId> _toPreloadViewer;
+	bool _toPreloadViewerFirstUrgent = false;
 	std::unique_ptr<StoryPreload> _preloading;
 	int _preloadingHiddenSourcesCounter = 0;
 	int _preloadingMainSourcesCounter = 0;
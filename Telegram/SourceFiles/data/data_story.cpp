@@ -235,9 +235,12 @@ public:
 	LoadTask(
 		FullStoryId id,
 		not_null<DocumentData*> document,
+		int priority,
 		Fn<void(QByteArray)> done);
 	~LoadTask();
 
+	void setPriority(int priority);
+
 private:
 	bool readyToRequest() const override;
 	int64 takeNextRequestOffset() override;
@@ -258,6 +261,7 @@ private:
 StoryPreload::LoadTask::LoadTask(
 	FullStoryId id,
 	not_null<DocumentData*> document,
+	int priority,
 	Fn<void(QByteArray)> done)
 : DownloadMtprotoTask(
 	&document->session().downloader(),
@@ -272,7 +276,7 @@ StoryPreload::LoadTask::LoadTask(
 	for (auto i = 0; i != parts; ++i) {
 		_parts.emplace(i * part, QByteArray());
 	}
-	addToQueue();
+	addToQueue(priority);
 }
 
 StoryPreload::LoadTask::~LoadTask() {
@@ -281,6 +285,12 @@ StoryPreload::LoadTask::~LoadTask() {
 	}
 }
 
+void StoryPreload::LoadTask::setPriority(int priority) {
+	if (!_finished && !_failed) {
+		addToQueue(priority);
+	}
+}
+
 bool StoryPreload::LoadTask::readyToRequest() const {
 	const auto part = Storage::kDownloadPartSize;
 	return !_failed && (_nextRequestOffset < _parts.size() * part);
@@ -998,9 +1008,13 @@ PeerData *Story::fromPeer() const {
 	return _fromPeer;
 }
 
-StoryPreload::StoryPreload(not_null<Story*> story, Fn<void()> done)
+StoryPreload::StoryPreload(
+	not_null<Story*> story,
+	int priority,
+	Fn<void()> done)
 : _story(story)
-, _done(std::move(done)) {
+, _done(std::move(done))
+, _priority(priority) {
 	start();
 }
 
@@ -1018,6 +1032,16 @@ not_null<Story*> StoryPreload::story() const {
 	return _story;
 }
 
+void StoryPreload::setPriority(int priority) {
+	if (_priority == priority) {
+		return;
+	}
+	_priority = priority;
+	if (_task) {
+		_task->setPriority(priority);
+	}
+}
+
 void StoryPreload::start() {
 	if (const auto photo = _story->photo()) {
 		_photo = photo->createMediaView();
@@ -1073,7 +1097,8 @@ void StoryPreload::load() {
 		callDone();
 		return;
 	}
-	_task = std::make_unique<LoadTask>(id(), video, [=](QByteArray data) {
+	_task = std::make_unique<LoadTask>(id(), video, _priority, [=](
+			QByteArray data) {
 		if (!data.isEmpty()) {
 			Assert(data.size() < Storage::kMaxFileInMemory);
 			_story->owner().cacheBigFile().putIfEmpty(
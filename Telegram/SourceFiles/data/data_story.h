@@ -294,12 +294,14 @@ private:
 
 class StoryPreload final : public base::has_weak_ptr {
 public:
-	StoryPreload(not_null<Story*> story, Fn<void()> done);
+	StoryPreload(not_null<Story*> story, int priority, Fn<void()> done);
 	~StoryPreload();
 
 	[[nodiscard]] FullStoryId id() const;
 	[[nodiscard]] not_null<Story*> story() const;
 
+	void setPriority(int priority);
+
 private:
 	class LoadTask;
 
@@ -309,6 +311,7 @@ private:
 
 	const not_null<Story*> _story;
 	Fn<void()> _done;
+	int _priority = 0;
 
 	std::shared_ptr<Data::PhotoMedia> _photo;
 	std::unique_ptr<LoadTask> _task;
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ffmpeg/ffmpeg_utility.h"
 
 #include "base/algorithm.h"
+#include "base/flat_map.h"
 #include "logs.h"
 
 #if !defined TDESKTOP_USE_PACKAGED && !defined Q_OS_WIN && !defined Q_OS_MAC
@@ -16,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #endif // !TDESKTOP_USE_PACKAGED && !Q_OS_WIN && !Q_OS_MAC
 
 #include <QImage>
+#include <QMutex>
 
 #ifdef LIB_FFMPEG_USE_QT_PRIVATE_API
 #include <private/qdrawhelper_p.h>
@@ -46,9 +48,158 @@ struct HwAccelDescriptor {
 	AVPixelFormat format = AV_PIX_FMT_NONE;
 };
 
+// Frame storage buffers are kept in buckets of close sizes, so that
+// resizing a video back and forth or several players with same sized
+// frames don't allocate a new buffer for each converted frame.
+// Buffers that were not reused for a while are freed.
+constexpr auto kFrameStoragePoolLimit = 64 * 1024 * 1024;
+constexpr auto kFrameStorageBucketLimit = 4;
+constexpr auto kFrameStorageBucketMin = 4096;
+constexpr auto kFrameStorageIdleTimeout = crl::time(3000);
+constexpr auto kFrameStorageStatsPeriod = crl::time(1000);
+
+class FrameStoragePool final {
+public:
+	[[nodiscard]] uchar *take(int size);
+	void put(uchar *buffer);
+
+private:
+	struct Header {
+		int capacity = 0;
+	};
+	struct Pooled {
+		uchar *allocated = nullptr;
+		crl::time released = 0;
+	};
+	static constexpr auto kHeaderSize = int(sizeof(Header));
+
+	[[nodiscard]] static int BucketCapacity(int size);
+	[[nodiscard]] std::vector<uchar*> collectIdle(crl::time now);
+	void reportStats(crl::time now);
+
+	QMutex _mutex;
+	base::flat_map<int, std::vector<Pooled>> _buckets;
+	int _pooledBytes = 0;
+	int _allocations = 0;
+	int _reuses = 0;
+	crl::time _statsStarted = 0;
+
+};
+
+int FrameStoragePool::BucketCapacity(int size) {
+	if (size <= kFrameStorageBucketMin) {
+		return kFrameStorageBucketMin;
+	}
+
+	// Eight buckets between each two powers of two, <= 12.5% waste.
+	auto step = 1;
+	while ((step << 4) <= size) {
+		step <<= 1;
+	}
+	return ((size + step - 1) / step) * step;
+}
+
+std::vector<uchar*> FrameStoragePool::collectIdle(crl::time now) {
+	auto result = std::vector<uchar*>();
+	for (auto i = begin(_buckets); i != end(_buckets);) {
+		auto &list = i->second;
+
+		// The least recently released buffers are in the beginning.
+		const auto from = begin(list);
+		const auto till = ranges::find_if(list, [&](const Pooled &entry) {
+			return (now - entry.released) < kFrameStorageIdleTimeout;
+		});
+		for (auto j = from; j != till; ++j) {
+			result.push_back(j->allocated);
+			_pooledBytes -= i->first;
+		}
+		list.erase(from, till);
+		i = list.empty() ? _buckets.erase(i) : std::next(i);
+	}
+	return result;
+}
+
+uchar *FrameStoragePool::take(int size) {
+	const auto capacity = BucketCapacity(size);
+	const auto now = crl::now();
+
+	QMutexLocker lock(&_mutex);
+	reportStats(now);
+	const auto idle = collectIdle(now);
+	auto reused = (uchar*)nullptr;
+	const auto i = _buckets.find(capacity);
+	if (i != end(_buckets) && !i->second.empty()) {
+		reused = i->second.back().allocated;
+		i->second.pop_back();
+		_pooledBytes -= capacity;
+		++_reuses;
+	} else {
+		++_allocations;
+	}
+	lock.unlock();
+
+	for (const auto allocated : idle) {
+		delete[] allocated;
+	}
+	if (reused) {
+		return reused + kHeaderSize;
+	}
+	const auto result = new uchar[kHeaderSize + capacity];
+	reinterpret_cast<Header*>(result)->capacity = capacity;
+	return result + kHeaderSize;
+}
+
+void FrameStoragePool::put(uchar *buffer) {
+	const auto allocated = buffer - kHeaderSize;
+	const auto capacity = reinterpret_cast<Header*>(allocated)->capacity;
+	const auto now = crl::now();
+
+	QMutexLocker lock(&_mutex);
+	auto idle = collectIdle(now);
+	auto &list = _buckets[capacity];
+	if (int(list.size()) < kFrameStorageBucketLimit
+		&& _pooledBytes + capacity <= kFrameStoragePoolLimit) {
+		list.push_back({ allocated, now });
+		_pooledBytes += capacity;
+	} else {
+		idle.push_back(allocated);
+		if (list.empty()) {
+			_buckets.remove(capacity);
+		}
+	}
+	lock.unlock();
+
+	for (const auto allocated : idle) {
+		delete[] allocated;
+	}
+}
+
+void FrameStoragePool::reportStats(crl::time now) {
+	if (!_statsStarted) {
+		_statsStarted = now;
+		return;
+	} else if (now - _statsStarted < kFrameStorageStatsPeriod) {
+		return;
+	} else if (_allocations > 0) {
+		DEBUG_LOG(("Video Info: Frame storage pool, "
+			"%1 allocations and %2 reuses per %3ms, %4 bytes pooled."
+			).arg(_allocations
+			).arg(_reuses
+			).arg(now - _statsStarted
+			).arg(_pooledBytes));
+	}
+	_statsStarted = now;
+	_allocations = _reuses = 0;
+}
+
+[[nodiscard]] FrameStoragePool &FrameStorages() {
+	// Never destroyed, because images may outlive static objects.
+	static const auto result = new FrameStoragePool();
+	return *result;
+}
+
 void AlignedImageBufferCleanupHandler(void* data) {
-	const auto buffer = static_cast<uchar*>(data);
-	delete[] buffer;
+	FrameStorages().put(static_cast<uchar*>(data));
 }
 
 [[nodiscard]] bool IsValidAspectRatio(AVRational aspect) {
@@ -560,7 +711,8 @@ QImage CreateFrameStorage(QSize size) {
 		? (widthAlign - (width % widthAlign))
 		: 0);
 	const auto perLine = neededWidth * kPixelBytesSize;
-	const auto buffer = new uchar[perLine * height + kAlignImageBy];
+	const auto buffer = FrameStorages().take(
+		perLine * height + kAlignImageBy);
 	const auto cleanupData = static_cast<void *>(buffer);
 	const auto address = reinterpret_cast<uintptr_t>(buffer);
 	const auto alignedBuffer = buffer + ((address % kAlignImageBy)
@@ -81,6 +81,20 @@ using UpdateFlag = Data::HistoryUpdate::Flag;
 	return fields;
 }
 
+[[nodiscard]] bool HasOnlyRegularItems(not_null<HistoryBlock*> block) {
+	return ranges::all_of(block->messages, [](const auto &view) {
+		return view->data()->isRegular();
+	});
+}
+
+void UnloadBlock(not_null<HistoryBlock*> block) {
+	// Remove from the back of the block to avoid reindexing.
+	// The block is deleted together with its last view.
+	for (auto left = int(block->messages.size()); left != 0; --left) {
+		block->messages.back()->data()->removeMainView();
+	}
+}
+
 } // namespace
 
 History::History(not_null<Data::Session*> owner, PeerId peerId)
@@ -3478,6 +3492,48 @@ void History::clearUpTill(MsgId availableMinId) {
 	requestChatListMessage();
 }
 
+bool History::unloadOlderBlocks(int count) {
+	Expects(!isBuildingFrontBlock());
+
+	accumulate_min(count, int(blocks.size()) - 1);
+	for (auto i = 0; i < count; ++i) {
+		if (!HasOnlyRegularItems(blocks[i].get())) {
+			count = i;
+			break;
+		}
+	}
+	if (count <= 0) {
+		return false;
+	}
+	for (auto i = 0; i != count; ++i) {
+		UnloadBlock(blocks.front().get());
+	}
+	_loadedAtTop = false;
+	setHasPendingResizedItems();
+	return true;
+}
+
+bool History::unloadNewerBlocks(int count) {
+	Expects(!isBuildingFrontBlock());
+
+	accumulate_min(count, int(blocks.size()) - 1);
+	for (auto i = 0; i < count; ++i) {
+		if (!HasOnlyRegularItems(blocks[blocks.size() - i - 1].get())) {
+			count = i;
+			break;
+		}
+	}
+	if (count <= 0) {
+		return false;
+	}
+	for (auto i = 0; i != count; ++i) {
+		UnloadBlock(blocks.back().get());
+	}
+	_loadedAtBottom = false;
+	setHasPendingResizedItems();
+	return true;
+}
+
 void History::applyGroupAdminChanges(const base::flat_set<UserId> &changes) {
 	for (const auto &block : blocks) {
 		for (const auto &message : block->messages) {
@@ -127,6 +127,12 @@ public:
 	void clear(ClearType type);
 	void clearUpTill(MsgId availableMinId);
 
+	// Destroy views of the blocks far from the visible part,
+	// keeping the items, so they could be shown again without
+	// rebuilding them from scratch. Returns false if nothing was done.
+	bool unloadOlderBlocks(int count);
+	bool unloadNewerBlocks(int count);
+
 	void applyGroupAdminChanges(const base::flat_set<UserId> &changes);
 
 	template <typename ...Args>
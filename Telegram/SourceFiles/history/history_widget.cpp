@@ -165,6 +165,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/ui_integration.h"
 #include "support/support_common.h"
 #include "support/support_autocomplete.h"
+#include "support/support_helper.h"
 #include "support/support_preload.h"
 #include "dialogs/dialogs_key.h"
 #include "calls/calls_instance.h"
@@ -183,6 +184,8 @@ namespace {
 constexpr auto kMessagesPerPageFirst = 30;
 constexpr auto kMessagesPerPage = 50;
 constexpr auto kPreloadHeightsCount = 3; // when 3 screens to scroll left make a preload request
+constexpr auto kUnloadHeightsCount = 12; // when 12 screens away unload views
+constexpr auto kSupportPreloadChatsCount = 3;
 constexpr auto kScrollToVoiceAfterScrolledMs = 1000;
 constexpr auto kSkipRepaintWhileScrollMs = 100;
 constexpr auto kShowMembersDropdownTimeoutMs = 300;
@@ -980,7 +983,7 @@ HistoryWidget::HistoryWidget(
 	if (session().supportMode()) {
 		session().data().chatListEntryRefreshes(
 		) | rpl::start_with_next([=] {
-			crl::on_main(this, [=] { checkSupportPreload(true); });
+			crl::on_main(this, [=] { checkSupportPreload(); });
 		}, lifetime());
 	}
 
@@ -2457,6 +2460,11 @@ void HistoryWidget::showHistory(
 		setupGroupCallBar();
 		setupRequestsBar();
 		checkMessagesTTL();
+		if (session().supportMode()) {
+			session().supportHelper().preloader().shown(
+				_history,
+				_history->isReadyFor(_showAtMsgId));
+		}
 		if (_history->scrollTopItem
 			|| (_migrated && _migrated->scrollTopItem)
 			|| _history->isReadyFor(_showAtMsgId)) {
@@ -2576,7 +2584,6 @@ void HistoryWidget::setHistory(History *history) {
 	if (_history) {
 		unregisterDraftSources();
 		clearAllLoadRequests();
-		clearSupportPreloadRequest();
 		const auto wasHistory = base::take(_history);
 		const auto wasMigrated = base::take(_migrated);
 		unloadHeavyViewParts(wasHistory);
@@ -2726,16 +2733,6 @@ void HistoryWidget::clearDelayedShowAtRequest() {
 	}
 }
 
-void HistoryWidget::clearSupportPreloadRequest() {
-	Expects(_history != nullptr);
-
-	if (_supportPreloadRequest) {
-		auto &histories = _history->owner().histories();
-		histories.cancelRequest(_supportPreloadRequest);
-		_supportPreloadRequest = 0;
-	}
-}
-
 void HistoryWidget::clearAllLoadRequests() {
 	Expects(_history != nullptr);
 
@@ -3890,39 +3887,82 @@ void HistoryWidget::preloadHistoryByScroll() {
 	if (scrollTop <= kPreloadHeightsCount * scrollHeight) {
 		loadMessages();
 	}
+	unloadFarBlocks();
 	if (session().supportMode()) {
 		crl::on_main(this, [=] { checkSupportPreload(); });
 	}
 }
 
-void HistoryWidget::checkSupportPreload(bool force) {
+void HistoryWidget::unloadFarBlocks() {
+	if (!_history || _migrated) {
+		return;
+	}
+	const auto scrollTop = _scroll->scrollTop();
+	const auto scrollHeight = _scroll->height();
+	const auto top = _list->historyTop();
+	if (top < 0) {
+		return;
+	}
+	const auto keepFrom = scrollTop
+		- kUnloadHeightsCount * scrollHeight
+		- top;
+	const auto keepTill = scrollTop
+		+ (kUnloadHeightsCount + 1) * scrollHeight
+		- top;
+
+	// Don't leave a gap for the messages that are being loaded right now.
+	auto older = 0;
+	if (!_preloadRequest) {
+		for (const auto &block : _history->blocks) {
+			if (block->y() + block->height() > keepFrom) {
+				break;
+			}
+			++older;
+		}
+	}
+	auto newer = 0;
+	if (!_preloadDownRequest) {
+		for (const auto &block : ranges::views::reverse(_history->blocks)) {
+			if (block->y() < keepTill) {
+				break;
+			}
+			++newer;
+		}
+	}
+	const auto unloadedOlder = _history->unloadOlderBlocks(older);
+	const auto unloadedNewer = _history->unloadNewerBlocks(newer);
+	if (unloadedOlder || unloadedNewer) {
+		updateHistoryGeometry();
+		_cornerButtons.updateJumpDownVisibility();
+	}
+}
+
+void HistoryWidget::checkSupportPreload() {
 	if (!_history
 		|| _firstLoadRequest
 		|| _preloadRequest
 		|| _preloadDownRequest
-		|| (_supportPreloadRequest && !force)
 		|| controller()->activeChatEntryCurrent().key.history() != _history) {
 		return;
 	}
 
 	const auto setting = session().settings().supportSwitch();
 	const auto command = Support::GetSwitchCommand(setting);
-	const auto descriptor = !command
-		? Dialogs::RowDescriptor()
-		: (*command == Shortcuts::Command::ChatNext)
-		? controller()->resolveChatNext()
-		: controller()->resolveChatPrevious();
-	auto history = descriptor.key.history();
-	if (!history || _supportPreloadHistory == history) {
-		return;
+	auto queue = std::vector<not_null<History*>>();
+	auto descriptor = Dialogs::RowDescriptor();
+	while (command && int(queue.size()) < kSupportPreloadChatsCount) {
+		descriptor = (*command == Shortcuts::Command::ChatNext)
+			? controller()->resolveChatNext(descriptor)
+			: controller()->resolveChatPrevious(descriptor);
+		const auto history = descriptor.key.history();
+		if (!history
+			|| history == _history
+			|| ranges::contains(queue, not_null(history))) {
+			break;
+		}
+		queue.push_back(history);
 	}
-	clearSupportPreloadRequest();
-	_supportPreloadHistory = history;
-	_supportPreloadRequest = Support::SendPreloadRequest(history, [=] {
-		_supportPreloadRequest = 0;
-		_supportPreloadHistory = nullptr;
-		crl::on_main(this, [=] { checkSupportPreload(); });
-	});
+	session().supportHelper().preloader().setQueue(std::move(queue));
 }
 
 void HistoryWidget::checkReplyReturns() {
@@ -239,7 +239,6 @@ public:
 		Ui::ReportReason reason,
 		Fn<void(MessageIdsList)> callback);
 	void clearAllLoadRequests();
-	void clearSupportPreloadRequest();
 	void clearDelayedShowAtRequest();
 	void clearDelayedShowAt();
 
@@ -619,7 +618,8 @@ private:
 	[[nodiscard]] bool readyToForward() const;
 	[[nodiscard]] bool hasSilentToggle() const;
 
-	void checkSupportPreload(bool force = false);
+	void checkSupportPreload();
+	void unloadFarBlocks();
 	void handleSupportSwitch(not_null<History*> updated);
 
 	[[nodiscard]] bool isRecording() const;
@@ -715,9 +715,6 @@ private:
 	int _delayedShowAtMsgHighlightPartOffsetHint = 0;
 	int _delayedShowAtRequest = 0; // Not real mtpRequestId.
 
-	History *_supportPreloadHistory = nullptr;
-	int _supportPreloadRequest = 0; // Not real mtpRequestId.
-
 	object_ptr<HistoryView::TopBarWidget> _topBar;
 	object_ptr<Ui::ContinuousScroll> _scroll;
 	QPointer<HistoryInner> _list;
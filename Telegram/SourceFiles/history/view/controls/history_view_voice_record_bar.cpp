@@ -27,6 +27,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/audio/media_audio_capture.h"
 #include "media/player/media_player_button.h"
 #include "media/player/media_player_instance.h"
+#include "storage/file_upload.h"
 #include "ui/controls/send_button.h"
 #include "ui/effects/animation_value.h"
 #include "ui/effects/animation_value_f.h"
@@ -1246,6 +1247,9 @@ VoiceRecordBar::~VoiceRecordBar() {
 	if (isRecording()) {
 		stopRecording(StopType::Cancel);
 	}
+
+	// In the listen state the recording is paused, not stopped.
+	cancelStreamedUpload();
 }
 
 void VoiceRecordBar::updateMessageGeometry() {
@@ -1664,6 +1668,8 @@ void VoiceRecordBar::startRecording() {
 			_paused = false;
 			instance()->pause(false, nullptr);
 		} else {
+			cancelStreamedUpload();
+			_streamedUploadId = _show->session().uploader().startStreamed();
 			instance()->start();
 		}
 		instance()->updated(
@@ -1673,6 +1679,14 @@ void VoiceRecordBar::startRecording() {
 		}, [=] {
 			stop(false);
 		}, _recordingLifetime);
+		instance()->encoded(
+		) | rpl::start_with_next([=](const QByteArray &bytes) {
+			if (_streamedUploadId) {
+				_show->session().uploader().appendStreamed(
+					_streamedUploadId,
+					bytes);
+			}
+		}, _recordingLifetime);
 		_recordingLifetime.add([=] {
 			_recording = false;
 		});
@@ -1765,9 +1779,16 @@ void VoiceRecordBar::hideFast() {
 	[[maybe_unused]] const auto s = takeTTLState();
 }
 
+void VoiceRecordBar::cancelStreamedUpload() {
+	if (const auto id = base::take(_streamedUploadId)) {
+		_show->session().uploader().cancelStreamed(id);
+	}
+}
+
 void VoiceRecordBar::stopRecording(StopType type, bool ttlBeforeHide) {
 	using namespace ::Media::Capture;
 	if (type == StopType::Cancel) {
+		cancelStreamedUpload();
 		instance()->stop(crl::guard(this, [=](Result &&data) {
 			_cancelRequests.fire({});
 		}));
@@ -1797,6 +1818,7 @@ void VoiceRecordBar::stopRecording(StopType type, bool ttlBeforeHide) {
 		instance()->stop(crl::guard(this, [=](Result &&data) {
 			if (data.bytes.isEmpty()) {
 				// Close everything.
+				cancelStreamedUpload();
 				stop(false);
 				return;
 			}
@@ -1809,6 +1831,9 @@ void VoiceRecordBar::stopRecording(StopType type, bool ttlBeforeHide) {
 					? std::numeric_limits<int>::max()
 					: 0),
 			};
+
+			// Uploader continues the streamed upload when sending.
+			_streamedUploadId = 0;
 			_sendVoiceRequests.fire({
 				_data.bytes,
 				_data.waveform,
@@ -1876,6 +1901,7 @@ void VoiceRecordBar::requestToSendWithOptions(Api::SendOptions options) {
 		if (takeTTLState()) {
 			options.ttlSeconds = std::numeric_limits<int>::max();
 		}
+		_streamedUploadId = 0;
 		_sendVoiceRequests.fire({
 			_data.bytes,
 			_data.waveform,
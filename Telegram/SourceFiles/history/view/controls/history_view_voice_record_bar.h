@@ -128,6 +128,7 @@ private:
 
 	void stop(bool send);
 	void stopRecording(StopType type, bool ttlBeforeHide = false);
+	void cancelStreamedUpload();
 	void visibilityAnimate(bool show, Fn<void()> &&callback);
 
 	[[nodiscard]] bool showRecordButton() const;
@@ -164,6 +165,7 @@ private:
 	std::unique_ptr<ListenWrap> _listen;
 
 	::Media::Capture::Result _data;
+	uint64 _streamedUploadId = 0;
 	rpl::variable<bool> _paused;
 
 	base::Timer _startTimer;
@@ -217,6 +217,27 @@ const ListSection::Items &ListSection::items() const {
 	return _items;
 }
 
+void ListSection::forEachItemInClip(
+		QRect clip,
+		Fn<void(not_null<BaseLayout*>, QRect)> callback) const {
+	if (!_mosaic.empty()) {
+		_mosaic.paint([&](not_null<BaseLayout*> item, QPoint point) {
+			callback(item, findItemRect(item));
+		}, clip);
+		return;
+	}
+	const auto fromIt = findItemAfterTop(clip.y());
+	const auto tillIt = findItemAfterBottom(
+		fromIt,
+		clip.y() + clip.height());
+	for (auto it = fromIt; it != tillIt; ++it) {
+		const auto rect = findItemRect(*it);
+		if (rect.intersects(clip)) {
+			callback(*it, rect);
+		}
+	}
+}
+
 void ListSection::paint(
 		Painter &p,
 		const ListContext &context,
@@ -40,6 +40,9 @@ public:
 
 	using Items = std::vector<not_null<BaseLayout*>>;
 	const Items &items() const;
+	void forEachItemInClip(
+		QRect clip,
+		Fn<void(not_null<BaseLayout*>, QRect)> callback) const;
 
 	void paint(
 		Painter &p,
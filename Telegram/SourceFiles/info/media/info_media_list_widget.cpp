@@ -165,6 +165,9 @@ void ListWidget::start() {
 			_overLayout = nullptr;
 		}
 		_heavyLayouts.remove(layout);
+		if (_heavyPreloadFirst == layout || _heavyPreloadLast == layout) {
+			_heavyPreloadFirst = _heavyPreloadLast = nullptr;
+		}
 	}, lifetime());
 
 	_provider->refreshed(
@@ -559,6 +562,8 @@ void ListWidget::refreshRows() {
 	resizeToWidth(width());
 	restoreScrollState();
 	mouseActionUpdate();
+	_heavyPreloadFirst = _heavyPreloadLast = nullptr;
+	preloadHeavyItems();
 	update();
 }
 
@@ -639,6 +644,7 @@ void ListWidget::visibleTopBottomUpdated(
 
 	checkMoveToOtherViewer();
 	clearHeavyItems();
+	preloadHeavyItems();
 
 	if (_dateBadge->goodType) {
 		updateDateBadgeFor(_visibleTop);
@@ -743,6 +749,56 @@ void ListWidget::clearHeavyItems() {
 	}
 }
 
+void ListWidget::preloadHeavyItems() {
+	const auto visibleHeight = _visibleBottom - _visibleTop;
+	if (visibleHeight <= 0 || _sections.empty()) {
+		return;
+	}
+	struct Preload {
+		not_null<BaseLayout*> layout;
+		int distance = 0;
+		int top = 0;
+	};
+	auto list = std::vector<Preload>();
+
+	// Same range that clearHeavyItems() keeps alive.
+	const auto from = _visibleTop - visibleHeight;
+	const auto till = _visibleBottom + visibleHeight;
+	const auto fromSectionIt = findSectionAfterTop(from);
+	const auto tillSectionIt = findSectionAfterBottom(fromSectionIt, till);
+	for (auto it = fromSectionIt; it != tillSectionIt; ++it) {
+		const auto top = it->top();
+		it->forEachItemInClip(
+			QRect(0, from - top, width(), till - from),
+			[&](not_null<BaseLayout*> layout, QRect rect) {
+				const auto itemTop = top + rect.y();
+				const auto itemBottom = itemTop + rect.height();
+				const auto distance = (itemBottom <= _visibleTop)
+					? (_visibleTop - itemBottom)
+					: (itemTop >= _visibleBottom)
+					? (itemTop - _visibleBottom)
+					: 0;
+				list.push_back({ layout, distance, itemTop });
+			});
+	}
+	if (list.empty()
+		|| (_heavyPreloadFirst == list.front().layout
+			&& _heavyPreloadLast == list.back().layout)) {
+		return;
+	}
+	_heavyPreloadFirst = list.front().layout;
+	_heavyPreloadLast = list.back().layout;
+
+	// The downloader serves the latest requests first, so we request
+	// the farthest items first and the topmost visible ones last.
+	ranges::stable_sort(list, ranges::greater(), [](const Preload &entry) {
+		return std::make_pair(entry.distance, entry.top);
+	});
+	for (const auto &entry : list) {
+		entry.layout->preloadHeavyPart();
+	}
+}
+
 ListScrollTopState ListWidget::countScrollState() const {
 	if (_sections.empty() || _visibleTop <= 0) {
 		return {};
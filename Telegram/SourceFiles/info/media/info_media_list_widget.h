@@ -270,6 +270,7 @@ private:
 	void validateTrippleClickStartTime();
 	void checkMoveToOtherViewer();
 	void clearHeavyItems();
+	void preloadHeavyItems();
 
 	void setActionBoxWeak(QPointer<Ui::BoxContent> box);
 
@@ -278,6 +279,8 @@ private:
 
 	base::flat_set<not_null<const BaseLayout*>> _heavyLayouts;
 	bool _heavyLayoutsInvalidated = false;
+	const BaseLayout *_heavyPreloadFirst = nullptr;
+	const BaseLayout *_heavyPreloadLast = nullptr;
 	std::vector<Section> _sections;
 
 	int _visibleTop = 0;
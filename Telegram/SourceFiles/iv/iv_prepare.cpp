@@ -52,18 +52,34 @@ template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
 };
 
 [[nodiscard]] QByteArray Escape(QByteArray value) {
-	auto result = QByteArray();
-	result.reserve(value.size());
-	for (const auto &ch : value) {
+	const auto replacement = [](char ch) -> const char* {
 		switch (ch) {
-		case '&': result.append("&amp;"); break;
-		case '<': result.append("&lt;"); break;
-		case '>': result.append("&gt;"); break;
-		case '"': result.append("&quot;"); break;
-		case '\'': result.append("&apos;"); break;
-		default: result.append(ch); break;
+		case '&': return "&amp;";
+		case '<': return "&lt;";
+		case '>': return "&gt;";
+		case '"': return "&quot;";
+		case '\'': return "&apos;";
 		}
+		return nullptr;
+	};
+	const auto from = value.constData();
+	const auto till = from + value.size();
+	auto i = std::find_if(from, till, replacement);
+	if (i == till) {
+		// Most of the texts don't need escaping, share the same bytes.
+		return value;
 	}
+	auto result = QByteArray();
+	result.reserve(value.size() + value.size() / 8 + 8);
+	auto copied = from;
+	for (; i != till; ++i) {
+		if (const auto escaped = replacement(*i)) {
+			result.append(copied, i - copied);
+			result.append(escaped);
+			copied = i + 1;
+		}
+	}
+	result.append(copied, till - copied);
 	return result;
 }
 
@@ -969,15 +985,31 @@ QByteArray Parser::tag(
 		const QByteArray &name,
 		const Attributes &attributes,
 		const QByteArray &body) {
-	auto list = QByteArrayList();
-	list.reserve(attributes.size());
-	for (auto &[name, value] : attributes) {
-		list.push_back(' ' + name + (value ? "=\"" + *value + "\"" : ""));
+	// Tags are nested deeply in large pages, so build each of them
+	// in a single allocation instead of a chain of temporaries.
+	const auto isVoid = body.isEmpty() && IsVoidElement(name);
+	auto size = 1 + name.size() + (isVoid
+		? 3
+		: (1 + body.size() + 2 + name.size() + 1));
+	for (const auto &[key, value] : attributes) {
+		size += 1 + key.size() + (value ? (value->size() + 3) : 0);
+	}
+	auto result = QByteArray();
+	result.reserve(size);
+	result.append('<').append(name);
+	for (const auto &[key, value] : attributes) {
+		result.append(' ').append(key);
+		if (value) {
+			result.append("=\"").append(*value).append('"');
+		}
+	}
+	if (isVoid) {
+		result.append(" />");
+	} else {
+		result.append('>').append(body);
+		result.append("</").append(name).append('>');
 	}
-	const auto serialized = list.join(QByteArray());
-	return (IsVoidElement(name) && body.isEmpty())
-		? ('<' + name + serialized + " />")
-		: ('<' + name + serialized + '>' + body + "</" + name + '>');
+	return result;
 }
 
 QByteArray Parser::rich(const MTPRichText &text) {
@@ -988,13 +1020,16 @@ QByteArray Parser::rich(const MTPRichText &text) {
 			QByteArray from;
 			QByteArray to;
 		};
-		const auto replacements = std::vector<Replacement>{
+		auto text = utf(data.vtext());
+		if (!text.contains('\xE2')) {
+			return text;
+		}
+		static const auto replacements = std::vector<Replacement>{
 			{ "\xE2\x81\xA6", "<span dir=\"ltr\">" },
 			{ "\xE2\x81\xA7", "<span dir=\"rtl\">" },
 			{ "\xE2\x81\xA8", "<span dir=\"auto\">" },
 			{ "\xE2\x81\xA9", "</span>" },
 		};
-		auto text = utf(data.vtext());
 		for (const auto &[from, to] : replacements) {
 			text.replace(from, to);
 		}
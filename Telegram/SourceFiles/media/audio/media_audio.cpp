@@ -34,7 +34,6 @@ namespace {
 
 constexpr auto kSuppressRatioAll = 0.2;
 constexpr auto kSuppressRatioSong = 0.05;
-constexpr auto kWaveformCounterBufferSize = 256 * 1024;
 
 QMutex AudioMutex;
 ALCdevice *AudioDevice = nullptr;
@@ -1107,6 +1106,10 @@ void Fader::onTimer() {
 
 	auto volumeChangedAll = false;
 	auto volumeChangedSong = false;
+
+	// While all is suppressed with constant volume we don't need to
+	// check fading each kCheckFadingTimeout, only when it ends.
+	auto steadyTimeout = crl::time(0);
 	if (_suppressAll || _suppressSongAnim) {
 		auto ms = crl::now();
 		if (_suppressAll) {
@@ -1121,6 +1124,9 @@ void Fader::onTimer() {
 					_suppressVolumeAll.finish();
 					_suppressAllAnim = false;
 				}
+				steadyTimeout = std::max(
+					_suppressAllEnd - kFadeDuration - ms,
+					kCheckFadingTimeout);
 			} else if (ms > _suppressAllStart) {
 				_suppressVolumeAll.update((ms - _suppressAllStart) / float64(kMediaPlayerSuppressDuration), anim::linear);
 			}
@@ -1141,7 +1147,7 @@ void Fader::onTimer() {
 		accumulate_min(VolumeMultiplierSong, VolumeMultiplierAll);
 		volumeChangedSong = (VolumeMultiplierSong != wasVolumeMultiplierSong);
 	}
-	auto hasFading = (_suppressAll || _suppressSongAnim);
+	auto hasFading = (_suppressAll && !steadyTimeout) || _suppressSongAnim;
 	auto hasPlaying = false;
 
 	auto updatePlayback = [this, &hasPlaying, &hasFading](AudioMsgId::Type type, int index, float64 volumeMultiplier, bool suppressGainChanged) {
@@ -1171,9 +1177,14 @@ void Fader::onTimer() {
 		_timer.start(kCheckFadingTimeout);
 		Audio::StopDetachIfNotUsedSafe();
 	} else if (hasPlaying) {
-		_timer.start(kCheckPlaybackPositionTimeout);
+		_timer.start(steadyTimeout
+			? std::min(steadyTimeout, kCheckPlaybackPositionTimeout)
+			: kCheckPlaybackPositionTimeout);
 		Audio::StopDetachIfNotUsedSafe();
 	} else {
+		if (steadyTimeout) {
+			_timer.start(steadyTimeout);
+		}
 		Audio::ScheduleDetachIfNotUsedSafe();
 	}
 }
@@ -1543,31 +1554,18 @@ public:
 			return false;
 		}
 
-		QByteArray buffer;
-		buffer.reserve(kWaveformCounterBufferSize);
 		const auto samplesCount = samplesFrequency() * duration() / 1000;
-		int64 countbytes = sampleSize() * samplesCount;
-		int64 processed = 0;
-		int64 sumbytes = 0;
 		if (samplesCount < Media::Player::kWaveformSamplesCount) {
 			return false;
 		}
-
-		QVector<uint16> peaks;
-		peaks.reserve(Media::Player::kWaveformSamplesCount);
-
-		auto fmt = format();
-		auto peak = uint16(0);
-		auto callback = [&](uint16 sample) {
-			accumulate_max(peak, sample);
-			sumbytes += Media::Player::kWaveformSamplesCount;
-			if (sumbytes >= countbytes) {
-				sumbytes -= countbytes;
-				peaks.push_back(peak);
-				peak = 0;
-			}
-		};
-		while (processed < countbytes) {
+		_countbytes = sampleSize() * samplesCount;
+		_peaks.reserve(Media::Player::kWaveformSamplesCount);
+
+		// Peaks are accumulated from each decoded chunk right away,
+		// so the memory used doesn't depend on the file length.
+		const auto fmt = format();
+		auto processed = int64(0);
+		while (processed < _countbytes) {
 			const auto result = readMore();
 			Assert(result != ReadError::Wait); // Not a child loader.
 			if (result == ReadError::Retry) {
@@ -1580,26 +1578,26 @@ public:
 			const auto sampleBytes = v::get<bytes::const_span>(result);
 			Assert(!sampleBytes.empty());
 			if (fmt == AL_FORMAT_MONO8 || fmt == AL_FORMAT_STEREO8) {
-				Media::Audio::IterateSamples<uchar>(sampleBytes, callback);
+				accumulatePeaks<uchar>(sampleBytes);
 			} else if (fmt == AL_FORMAT_MONO16 || fmt == AL_FORMAT_STEREO16) {
-				Media::Audio::IterateSamples<int16>(sampleBytes, callback);
+				accumulatePeaks<int16>(sampleBytes);
 			}
 			processed += sampleBytes.size();
 		}
-		if (sumbytes > 0 && peaks.size() < Media::Player::kWaveformSamplesCount) {
-			peaks.push_back(peak);
+		if (_sumbytes > 0 && _peaks.size() < Media::Player::kWaveformSamplesCount) {
+			_peaks.push_back(_peak);
 		}
 
-		if (peaks.isEmpty()) {
+		if (_peaks.isEmpty()) {
 			return false;
 		}
 
-		auto sum = std::accumulate(peaks.cbegin(), peaks.cend(), 0LL);
-		peak = qMax(int32(sum * 1.8 / peaks.size()), 2500);
+		auto sum = std::accumulate(_peaks.cbegin(), _peaks.cend(), 0LL);
+		const auto peak = uint16(qMax(int32(sum * 1.8 / _peaks.size()), 2500));
 
-		result.resize(peaks.size());
-		for (int32 i = 0, l = peaks.size(); i != l; ++i) {
-			result[i] = char(qMin(31U, uint32(qMin(peaks.at(i), peak)) * 31 / peak));
+		result.resize(_peaks.size());
+		for (int32 i = 0, l = _peaks.size(); i != l; ++i) {
+			result[i] = char(qMin(31U, uint32(qMin(_peaks.at(i), peak)) * 31 / peak));
 		}
 
 		return true;
@@ -1613,7 +1611,39 @@ public:
 	}
 
 private:
+	template <typename SampleType>
+	void accumulatePeaks(bytes::const_span bytes) {
+		constexpr auto kStep = int64(Media::Player::kWaveformSamplesCount);
+
+		auto samples = reinterpret_cast<const SampleType*>(bytes.data());
+		auto left = int64(bytes.size() / sizeof(SampleType));
+		while (left > 0) {
+			// Each sample adds kStep to _sumbytes, a peak is finished
+			// when _sumbytes reaches _countbytes. Find the max of all the
+			// samples till then in one tight loop.
+			const auto tillPeak = (_countbytes - _sumbytes + kStep - 1)
+				/ kStep;
+			const auto count = std::min(left, tillPeak);
+			auto peak = _peak;
+			for (const auto sample : gsl::make_span(samples, count)) {
+				accumulate_max(peak, Media::Audio::ReadOneSample(sample));
+			}
+			_peak = peak;
+			_sumbytes += count * kStep;
+			samples += count;
+			left -= count;
+			if (_sumbytes >= _countbytes) {
+				_sumbytes -= _countbytes;
+				_peaks.push_back(base::take(_peak));
+			}
+		}
+	}
+
 	VoiceWaveform result;
+	QVector<uint16> _peaks;
+	int64 _countbytes = 0;
+	int64 _sumbytes = 0;
+	uint16 _peak = 0;
 
 };
 
@@ -27,6 +27,7 @@ constexpr auto kCaptureSkipDuration = crl::time(400);
 constexpr auto kCaptureFadeInDuration = crl::time(300);
 constexpr auto kCaptureBufferSlice = 256 * 1024;
 constexpr auto kCaptureUpdateDelta = crl::time(100);
+constexpr auto kCaptureEncodedChunk = 32 * 1024;
 
 Instance *CaptureInstance = nullptr;
 
@@ -88,12 +89,14 @@ public:
 	void start(
 		Webrtc::DeviceResolvedId id,
 		Fn<void(Update)> updated,
+		Fn<void(QByteArray)> encoded,
 		Fn<void()> error);
 	void stop(Fn<void(Result&&)> callback = nullptr);
 	void pause(bool value, Fn<void(Result&&)> callback);
 
 private:
 	void process();
+	void sendEncoded();
 
 	[[nodiscard]] bool processFrame(int32 offset, int32 framesize);
 	void fail();
@@ -105,6 +108,7 @@ private:
 	[[nodiscard]] int writePackets();
 
 	Fn<void(Update)> _updated;
+	Fn<void(QByteArray)> _encoded;
 	Fn<void()> _error;
 
 	struct Private;
@@ -139,6 +143,10 @@ void Instance::start() {
 			crl::on_main(this, [=] {
 				_updates.fire_copy(update);
 			});
+		}, [=](QByteArray bytes) {
+			crl::on_main(this, [=] {
+				_encoded.fire_copy(bytes);
+			});
 		}, [=] {
 			crl::on_main(this, [=] {
 				_updates.fire_error({});
@@ -230,6 +238,7 @@ struct Instance::Inner::Private {
 
 	QByteArray data;
 	int32 dataPos = 0;
+	int32 encodedTill = 0;
 
 	int64 waveformMod = 0;
 	int64 waveformEach = (kCaptureFrequency / 100);
@@ -304,8 +313,10 @@ void Instance::Inner::fail() {
 void Instance::Inner::start(
 		Webrtc::DeviceResolvedId id,
 		Fn<void(Update)> updated,
+		Fn<void(QByteArray)> encoded,
 		Fn<void()> error) {
 	_updated = std::move(updated);
+	_encoded = std::move(encoded);
 	_error = std::move(error);
 	if (_paused) {
 		_paused = false;
@@ -614,6 +625,7 @@ void Instance::Inner::stop(Fn<void(Result&&)> callback) {
 		d->levelMax = 0;
 
 		d->dataPos = 0;
+		d->encodedTill = 0;
 		d->data.clear();
 
 		d->waveformMod = 0;
@@ -696,11 +708,23 @@ void Instance::Inner::process() {
 			memmove(_captured.data(), _captured.constData() + encoded, goodSize);
 			_captured.resize(goodSize);
 		}
+		sendEncoded();
 	} else {
 		DEBUG_LOG(("Audio Capture: no samples to capture."));
 	}
 }
 
+void Instance::Inner::sendEncoded() {
+	// The muxer only appends data, so the encoded bytes may be uploaded
+	// while recording. If it rewrites something the upload won't be used.
+	const auto size = d->data.size();
+	if (!_encoded || size - d->encodedTill < kCaptureEncodedChunk) {
+		return;
+	}
+	_encoded(d->data.mid(d->encodedTill));
+	d->encodedTill = size;
+}
+
 bool Instance::Inner::processFrame(int32 offset, int32 framesize) {
 	// Prepare audio frame
 
@@ -38,6 +38,11 @@ public:
 		return _updates.events();
 	}
 
+	// Chunks of the encoded file, as they are written while recording.
+	[[nodiscard]] rpl::producer<QByteArray> encoded() const {
+		return _encoded.events();
+	}
+
 	[[nodiscard]] bool started() const {
 		return _started.current();
 	}
@@ -56,6 +61,7 @@ private:
 	bool _available = false;
 	rpl::variable<bool> _started = false;
 	rpl::event_stream<Update, rpl::empty_error> _updates;
+	rpl::event_stream<QByteArray> _encoded;
 	QThread _thread;
 	std::unique_ptr<Inner> _inner;
 
@@ -67,8 +67,12 @@ constexpr auto kSiblingUserpicSize = 0.3;
 constexpr auto kInnerHeightMultiplier = 1.6;
 constexpr auto kPreloadPeersCount = 3;
 constexpr auto kPreloadStoriesCount = 5;
-constexpr auto kPreloadNextMediaCount = 3;
+constexpr auto kPreloadNextMediaCount = 2;
+constexpr auto kPreloadNextMediaCountMax = 6;
 constexpr auto kPreloadPreviousMediaCount = 1;
+constexpr auto kPreloadAheadDuration = 6 * crl::time(1000);
+constexpr auto kPreloadUrgentDuration = 2 * crl::time(1000);
+constexpr auto kPreloadShownDurationMax = 20 * crl::time(1000);
 constexpr auto kMarkAsReadAfterSeconds = 0.2;
 constexpr auto kMarkAsReadAfterProgress = 0.;
 
@@ -171,6 +175,125 @@ private:
 
 };
 
+class Controller::PreloadPlanner final {
+public:
+	// Each method returns true if the preload plan has changed.
+	bool shown(crl::time now);
+	bool hidden();
+	bool playback(const Player::TrackState &state);
+	bool firstFrame(crl::time now);
+
+	[[nodiscard]] int nextCount() const;
+	[[nodiscard]] bool nextUrgent() const;
+
+private:
+	[[nodiscard]] crl::time nextExpectedIn() const;
+	bool refresh();
+
+	crl::time _shownAt = 0;
+	crl::time _averageShown = 0;
+	crl::time _remaining = 0;
+	crl::time _averageFirstFrame = 0;
+	int _nextCount = kPreloadNextMediaCount;
+	bool _nextUrgent = false;
+	bool _waitingFirstFrame = false;
+
+};
+
+bool Controller::PreloadPlanner::shown(crl::time now) {
+	if (_shownAt) {
+		// How long stories are watched before moving on, which is short
+		// for tapping through and the story duration for passive viewing.
+		const auto duration = std::min(
+			now - _shownAt,
+			kPreloadShownDurationMax);
+		_averageShown = _averageShown
+			? ((_averageShown * 3 + duration) / 4)
+			: duration;
+	}
+	_shownAt = now;
+	_remaining = 0;
+	_waitingFirstFrame = true;
+	return refresh();
+}
+
+bool Controller::PreloadPlanner::hidden() {
+	_shownAt = 0;
+	_remaining = 0;
+	_waitingFirstFrame = false;
+	return refresh();
+}
+
+bool Controller::PreloadPlanner::playback(const Player::TrackState &state) {
+	if (!state.frequency
+		|| !state.length
+		|| Player::IsStoppedOrStopping(state.state)) {
+		return false;
+	}
+	const auto left = std::max(state.length - state.position, int64());
+	_remaining = std::max(
+		crl::time(left * 1000 / state.frequency),
+		crl::time(1));
+	return refresh();
+}
+
+bool Controller::PreloadPlanner::firstFrame(crl::time now) {
+	if (!_waitingFirstFrame) {
+		return false;
+	}
+	_waitingFirstFrame = false;
+	const auto duration = now - _shownAt;
+	_averageFirstFrame = _averageFirstFrame
+		? ((_averageFirstFrame * 3 + duration) / 4)
+		: duration;
+	DEBUG_LOG(("Stories Info: First frame in %1 ms, average %2 ms, "
+		"preloading %3 next."
+		).arg(duration
+		).arg(_averageFirstFrame
+		).arg(_nextCount));
+	return refresh();
+}
+
+int Controller::PreloadPlanner::nextCount() const {
+	return _nextCount;
+}
+
+bool Controller::PreloadPlanner::nextUrgent() const {
+	return _nextUrgent;
+}
+
+crl::time Controller::PreloadPlanner::nextExpectedIn() const {
+	return !_averageShown
+		? _remaining
+		: !_remaining
+		? _averageShown
+		: std::min(_remaining, _averageShown);
+}
+
+bool Controller::PreloadPlanner::refresh() {
+	const auto in = nextExpectedIn();
+	const auto count = [&] {
+		if (!_averageShown) {
+			return kPreloadNextMediaCount;
+		}
+		// Cover the time of kPreloadAheadDuration with preloaded stories.
+		const auto more = (in < kPreloadAheadDuration)
+			? ((kPreloadAheadDuration - in + _averageShown - 1)
+				/ _averageShown)
+			: crl::time();
+		return int(std::min(1 + more, crl::time(kPreloadNextMediaCountMax)));
+	}();
+	const auto urgent = !_waitingFirstFrame
+		&& (in > 0)
+		&& (in < kPreloadUrgentDuration);
+	if (_nextCount == count && _nextUrgent == urgent) {
+		return false;
+	}
+	_nextCount = count;
+	_nextUrgent = urgent;
+	return true;
+}
+
 Controller::PhotoPlayback::PhotoPlayback(not_null<Controller*> controller)
 : _controller(controller)
 , _timer([=] { callback(); })
@@ -293,6 +416,7 @@ Controller::Controller(not_null<Delegate*> delegate)
 , _replyArea(std::make_unique<ReplyArea>(this))
 , _reactions(std::make_unique<Reactions>(this))
 , _recentViews(std::make_unique<RecentViews>(this))
+, _preloadPlanner(std::make_unique<PreloadPlanner>())
 , _weatherInCelsius(ResolveWeatherInCelsius()){
 	initLayout();
 
@@ -813,11 +937,12 @@ void Controller::rebuildFromContext(
 void Controller::preloadNext() {
 	Expects(shown());
 
+	const auto nextCount = _preloadPlanner->nextCount();
 	auto ids = std::vector<FullStoryId>();
-	ids.reserve(kPreloadPreviousMediaCount + kPreloadNextMediaCount);
+	ids.reserve(kPreloadPreviousMediaCount + nextCount);
 	const auto peer = shownPeer();
 	const auto count = shownCount();
-	const auto till = std::min(_index + kPreloadNextMediaCount, count);
+	const auto till = std::min(_index + 1 + nextCount, count);
 	for (auto i = _index + 1; i != till; ++i) {
 		ids.push_back({ .peer = peer->id, .story = shownId(i) });
 	}
@@ -825,7 +950,9 @@ void Controller::preloadNext() {
 	for (auto i = _index; i != from;) {
 		ids.push_back({ .peer = peer->id, .story = shownId(--i) });
 	}
-	peer->owner().stories().setPreloadingInViewer(std::move(ids));
+	peer->owner().stories().setPreloadingInViewer(
+		std::move(ids),
+		_preloadPlanner->nextUrgent());
 }
 
 void Controller::checkMoveByDelta() {
@@ -986,6 +1113,11 @@ bool Controller::changeShown(Data::Story *story) {
 		story->owner().stories().registerPolling(
 			story,
 			Data::Stories::Polling::Viewer);
+		if (_preloadPlanner->shown(crl::now()) && shown()) {
+			preloadNext();
+		}
+	} else {
+		_preloadPlanner->hidden();
 	}
 
 	_viewed = false;
@@ -1197,6 +1329,9 @@ void Controller::ready() {
 	_started = true;
 	updatePlayingAllowed();
 	_reactions->ready();
+	if (_preloadPlanner->firstFrame(crl::now()) && shown()) {
+		preloadNext();
+	}
 }
 
 void Controller::updateVideoPlayback(const Player::TrackState &state) {
@@ -1208,6 +1343,9 @@ void Controller::updatePhotoPlayback(const Player::TrackState &state) {
 }
 
 void Controller::updatePlayback(const Player::TrackState &state) {
+	if (_preloadPlanner->playback(state) && shown()) {
+		preloadNext();
+	}
 	_slider->updatePlayback(state);
 	updatePowerSaveBlocker(state);
 	maybeMarkAsRead(state);
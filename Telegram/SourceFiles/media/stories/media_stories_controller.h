@@ -187,6 +187,7 @@ public:
 private:
 	class PhotoPlayback;
 	class Unsupported;
+	class PreloadPlanner;
 	using ChosenReaction = HistoryView::Reactions::ChosenReaction;
 	struct StoriesList {
 		not_null<PeerData*> peer;
@@ -276,6 +277,7 @@ private:
 	const std::unique_ptr<RecentViews> _recentViews;
 	std::unique_ptr<Unsupported> _unsupported;
 	std::unique_ptr<PhotoPlayback> _photoPlayback;
+	const std::unique_ptr<PreloadPlanner> _preloadPlanner;
 	std::unique_ptr<CaptionFullView> _captionFullView;
 	std::unique_ptr<RepostView> _repostView;
 
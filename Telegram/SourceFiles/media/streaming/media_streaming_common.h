@@ -111,6 +111,13 @@ struct Update {
 		Finished> data;
 };
 
+struct ReadingStats {
+	int stalls = 0;
+	crl::time stalledTime = 0;
+	int64 downloadSpeed = 0; // Bytes per second.
+	int preloadParts = 0;
+};
+
 enum class Error {
 	OpenFailed,
 	LoadFailed,
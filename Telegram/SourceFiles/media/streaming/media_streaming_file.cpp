@@ -11,12 +11,116 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/streaming/media_streaming_file_delegate.h"
 #include "ffmpeg/ffmpeg_utility.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace Media {
 namespace Streaming {
 namespace {
 
 constexpr auto kMaxSingleReadAmount = 8 * 1024 * 1024;
 constexpr auto kMaxQueuedPackets = 1024;
+constexpr auto kKeepIdleThreads = 4;
+constexpr auto kIdleThreadTimeout = std::chrono::seconds(10);
+
+// Demux loops block inside FFmpeg read callbacks, so each running file
+// still needs a thread of its own. But chats with many autoplaying
+// videos start and stop files all the time, so the threads are reused
+// instead of creating a new one for each File::start.
+class Threads final {
+public:
+	static Threads &Instance();
+
+	void run(FnMut<void()> task);
+
+	~Threads();
+
+private:
+	void loop();
+	void joinFinished(std::unique_lock<std::mutex> &lock);
+
+	std::mutex _mutex;
+	std::condition_variable _variable;
+	std::deque<FnMut<void()>> _tasks;
+	base::flat_map<std::thread::id, std::thread> _threads;
+	std::vector<std::thread> _finished;
+	int _idle = 0;
+	bool _stopping = false;
+
+};
+
+Threads &Threads::Instance() {
+	static auto result = Threads();
+	return result;
+}
+
+void Threads::run(FnMut<void()> task) {
+	auto lock = std::unique_lock<std::mutex>(_mutex);
+	joinFinished(lock);
+	_tasks.push_back(std::move(task));
+	if (_idle >= int(_tasks.size())) {
+		_variable.notify_one();
+		return;
+	}
+	auto thread = std::thread([=] { loop(); });
+	const auto id = thread.get_id();
+	_threads.emplace(id, std::move(thread));
+}
+
+void Threads::loop() {
+	crl::toggle_fp_exceptions(true);
+
+	auto lock = std::unique_lock<std::mutex>(_mutex);
+	while (true) {
+		if (_tasks.empty()) {
+			++_idle;
+			const auto timeout = !_variable.wait_for(
+				lock,
+				kIdleThreadTimeout,
+				[&] { return _stopping || !_tasks.empty(); });
+			--_idle;
+			if (_stopping
+				|| (timeout && _idle >= kKeepIdleThreads)) {
+				break;
+			} else if (_tasks.empty()) {
+				continue;
+			}
+		}
+		auto task = std::move(_tasks.front());
+		_tasks.pop_front();
+		lock.unlock();
+		task();
+		lock.lock();
+	}
+	if (!_stopping) {
+		const auto i = _threads.find(std::this_thread::get_id());
+		Assert(i != end(_threads));
+		_finished.push_back(std::move(i->second));
+		_threads.erase(i);
+	}
+}
+
+void Threads::joinFinished(std::unique_lock<std::mutex> &lock) {
+	auto finished = base::take(_finished);
+	lock.unlock();
+	for (auto &thread : finished) {
+		thread.join();
+	}
+	lock.lock();
+}
+
+Threads::~Threads() {
+	auto lock = std::unique_lock<std::mutex>(_mutex);
+	_stopping = true;
+	_variable.notify_all();
+	auto threads = base::take(_threads);
+	joinFinished(lock);
+	lock.unlock();
+	for (auto &[id, thread] : threads) {
+		thread.join();
+	}
+}
 
 [[nodiscard]] bool UnreliableFormatDuration(
 		not_null<AVFormatContext*> format,
@@ -243,6 +347,7 @@ void File::Context::seekToPosition(
 	//	return;
 	//}
 	//
+	const auto started = crl::now();
 	error = av_seek_frame(
 		format,
 		stream.index,
@@ -251,6 +356,10 @@ void File::Context::seekToPosition(
 			stream.timeBase),
 		AVSEEK_FLAG_BACKWARD);
 	if (!error) {
+		DEBUG_LOG(("Streaming Info: Seek to %1 took %2 ms (%3)."
+			).arg(position
+			).arg(crl::now() - started
+			).arg(_reader->isRemoteLoader() ? "remote" : "local"));
 		return;
 	}
 	return logFatal(qstr("av_seek_frame"), error);
@@ -312,6 +421,13 @@ void File::Context::start(StartOptions options) {
 	}
 
 	_reader->headerDone();
+	if (format->bit_rate > 0) {
+		_reader->setBitrate(format->bit_rate / 8);
+	} else if (const auto duration = std::max(
+			video.codec ? video.duration : kTimeUnknown,
+			audio.codec ? audio.duration : kTimeUnknown); duration > 0) {
+		_reader->setBitrate(_size * 1000 / duration);
+	}
 	if (_reader->isRemoteLoader()) {
 		sendFullInCache(true);
 	}
@@ -455,8 +571,8 @@ void File::start(not_null<FileDelegate*> delegate, StartOptions options) {
 	_reader->startStreaming();
 	_context.emplace(delegate, _reader.get());
 
-	_thread = std::thread([=, context = &*_context] {
-		crl::toggle_fp_exceptions(true);
+	_running = true;
+	Threads::Instance().run([=, context = &*_context] {
 		context->start(options);
 		while (!context->finished()) {
 			context->readNextPacket();
@@ -464,6 +580,7 @@ void File::start(not_null<FileDelegate*> delegate, StartOptions options) {
 		if (!context->interrupted()) {
 			context->stopStreamingAsync();
 		}
+		_done.release();
 	});
 }
 
@@ -474,9 +591,9 @@ void File::wake() {
 }
 
 void File::stop(bool stillActive) {
-	if (_thread.joinable()) {
+	if (base::take(_running)) {
 		_context->interrupt();
-		_thread.join();
+		_done.acquire();
 	}
 	_reader->stopStreaming(stillActive);
 	_context.reset();
@@ -486,6 +603,10 @@ bool File::isRemoteLoader() const {
 	return _reader->isRemoteLoader();
 }
 
+ReadingStats File::readingStats() const {
+	return _reader->stats();
+}
+
 void File::setLoaderPriority(int priority) {
 	_reader->setLoaderPriority(priority);
 }
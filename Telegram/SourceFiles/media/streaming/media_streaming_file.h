@@ -14,8 +14,6 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/bytes.h"
 #include "base/weak_ptr.h"
 
-#include <thread>
-
 namespace Media {
 namespace Streaming {
 
@@ -40,6 +38,7 @@ public:
 	void stop(bool stillActive = false);
 
 	[[nodiscard]] bool isRemoteLoader() const;
+	[[nodiscard]] ReadingStats readingStats() const;
 	void setLoaderPriority(int priority);
 
 	~File();
@@ -115,7 +114,8 @@ private:
 
 	std::optional<Context> _context;
 	std::shared_ptr<Reader> _reader;
-	std::thread _thread;
+	crl::semaphore _done;
+	bool _running = false;
 
 };
 
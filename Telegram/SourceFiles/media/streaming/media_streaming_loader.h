@@ -7,6 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/bytes.h"
+
 namespace Storage {
 class StreamedFileDownloader;
 } // namespace Storage
@@ -46,6 +48,19 @@ public:
 		not_null<Storage::StreamedFileDownloader*> downloader) = 0;
 	virtual void clearAttachedDownloader() = 0;
 
+	// Whole file is available right away (local file or bytes), so
+	// it can be read synchronously, bypassing parts() and slices.
+	[[nodiscard]] virtual bool directReadSupported() const {
+		return false;
+	}
+
+	// Streaming thread, only if directReadSupported().
+	[[nodiscard]] virtual bool readDirect(
+			int64 offset,
+			bytes::span buffer) {
+		return false;
+	}
+
 	virtual ~Loader() = default;
 
 };
@@ -31,9 +31,44 @@ LoaderLocal::LoaderLocal(std::unique_ptr<QIODevice> device)
 
 	if (!_size || !_device->open(QIODevice::ReadOnly)) {
 		fail();
+	} else {
+		_opened = true;
+		tryMap();
 	}
 }
 
+void LoaderLocal::tryMap() {
+	// Files are not mapped: a user file may be truncated or replaced
+	// while playing, and reading from such mapping crashes with SIGBUS.
+	if (const auto buffer = qobject_cast<QBuffer*>(_device.get())) {
+		const auto &data = buffer->data();
+		if (data.size() == _size) {
+			_mapped = bytes::make_span(data);
+		}
+	}
+}
+
+bool LoaderLocal::directReadSupported() const {
+	return _opened;
+}
+
+bool LoaderLocal::readDirect(int64 offset, bytes::span buffer) {
+	const auto size = int64(buffer.size());
+	if (!_mapped.empty()) {
+		if (offset + size > int64(_mapped.size())) {
+			return false;
+		}
+		bytes::copy(buffer, _mapped.subspan(offset, size));
+		return true;
+	} else if (_device->pos() != offset && !_device->seek(offset)) {
+		return false;
+	}
+
+	// The file may be truncated meanwhile, then it is a load failure.
+	const auto data = reinterpret_cast<char*>(buffer.data());
+	return (_device->read(data, size) == size);
+}
+
 Storage::Cache::Key LoaderLocal::baseCacheKey() const {
 	return {};
 }
@@ -38,11 +38,19 @@ public:
 		not_null<Storage::StreamedFileDownloader*> downloader) override;
 	void clearAttachedDownloader() override;
 
+	[[nodiscard]] bool directReadSupported() const override;
+	[[nodiscard]] bool readDirect(
+		int64 offset,
+		bytes::span buffer) override;
+
 private:
 	void fail();
+	void tryMap();
 
 	const std::unique_ptr<QIODevice> _device;
 	const int64 _size = 0;
+	bytes::const_span _mapped;
+	bool _opened = false;
 	rpl::event_stream<LoadedPart> _parts;
 
 };
@@ -881,6 +881,10 @@ rpl::producer<bool> Player::fullInCache() const {
 	return _fullInCache.events();
 }
 
+ReadingStats Player::readingStats() const {
+	return _file->readingStats();
+}
+
 QSize Player::videoSize() const {
 	return _information.video.size;
 }
@@ -59,6 +59,7 @@ public:
 
 	[[nodiscard]] rpl::producer<Update, Error> updates() const;
 	[[nodiscard]] rpl::producer<bool> fullInCache() const;
+	[[nodiscard]] ReadingStats readingStats() const;
 
 	[[nodiscard]] QSize videoSize() const;
 	[[nodiscard]] QImage frame(
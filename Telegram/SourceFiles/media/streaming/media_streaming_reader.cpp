@@ -21,10 +21,20 @@ constexpr auto kInSlice = uint32(kPartsInSlice * kPartSize);
 constexpr auto kMaxPartsInHeader = 64;
 constexpr auto kMaxOnlyInHeader = 80 * kPartSize;
 constexpr auto kPartsOutsideFirstSliceGood = 8;
-constexpr auto kSlicesInMemory = 2;
+constexpr auto kSlicesInMemoryMin = 2;
+constexpr auto kSlicesInMemoryMax = 8;
+
+// Slices partially loaded while seeking are cheap to keep in memory,
+// so we limit the loaded parts size and not only the slices count.
+constexpr auto kSlicesMemoryBudget = int64(24 * 1024 * 1024);
 
 // 1 MB of parts are requested from cloud ahead of reading demand.
+// For high bitrate streams it is raised up to 4 MB, if the connection
+// is fast enough to download several seconds of playback that way.
 constexpr auto kPreloadPartsAhead = 8;
+constexpr auto kPreloadPartsAheadMax = 32;
+constexpr auto kPreloadAheadTime = crl::time(4000);
+constexpr auto kDownloadSpeedWindow = crl::time(1000);
 constexpr auto kDownloaderRequestsLimit = 4;
 
 using PartsMap = base::flat_map<uint32, QByteArray>;
@@ -270,14 +280,14 @@ void Reader::Slice::addPart(uint32 offset, QByteArray bytes) {
 
 auto Reader::Slice::prepareFill(
 		uint32 from,
-		uint32 till) -> PrepareFillResult {
+		uint32 till,
+		int preloadParts) -> PrepareFillResult {
 	auto result = PrepareFillResult();
 
 	result.ready = false;
 	const auto fromOffset = (from / kPartSize) * kPartSize;
 	const auto tillPart = (till + kPartSize - 1) / kPartSize;
-	const auto preloadTillOffset = (tillPart + kPreloadPartsAhead)
-		* kPartSize;
+	const auto preloadTillOffset = (tillPart + preloadParts) * kPartSize;
 
 	const auto after = ranges::upper_bound(
 		parts,
@@ -548,7 +558,10 @@ void Reader::Slices::processPart(
 	checkSliceFullLoaded(index + 1);
 }
 
-auto Reader::Slices::fill(uint32 offset, bytes::span buffer) -> FillResult {
+auto Reader::Slices::fill(
+		uint32 offset,
+		bytes::span buffer,
+		int preloadParts) -> FillResult {
 	Expects(!buffer.empty());
 	Expects(offset < _size);
 	Expects(offset + buffer.size() <= _size);
@@ -562,7 +575,7 @@ auto Reader::Slices::fill(uint32 offset, bytes::span buffer) -> FillResult {
 		Assert(waitingForHeaderCache());
 		return {};
 	} else if (isFullInHeader()) {
-		return fillFromHeader(offset, buffer);
+		return fillFromHeader(offset, buffer, preloadParts);
 	}
 
 	auto result = FillResult();
@@ -605,14 +618,42 @@ auto Reader::Slices::fill(uint32 offset, bytes::span buffer) -> FillResult {
 	const auto secondTill = (till > (fromSlice + 1) * kInSlice)
 		? (till - (fromSlice + 1) * kInSlice)
 		: 0;
-	const auto first = _data[fromSlice].prepareFill(firstFrom, firstTill);
+	const auto first = _data[fromSlice].prepareFill(
+		firstFrom,
+		firstTill,
+		preloadParts);
 	const auto second = (fromSlice + 1 < tillSlice)
-		? _data[fromSlice + 1].prepareFill(secondFrom, secondTill)
+		? _data[fromSlice + 1].prepareFill(
+			secondFrom,
+			secondTill,
+			preloadParts)
 		: Slice::PrepareFillResult();
 	handlePrepareResult(fromSlice, first);
 	if (fromSlice + 1 < tillSlice) {
 		handlePrepareResult(fromSlice + 1, second);
 	}
+
+	// Continue reading ahead into the next slice, unless its parts
+	// may still be found in the cache.
+	const auto lastSlice = tillSlice - 1;
+	const auto preloadTill = (till - lastSlice * kInSlice)
+		+ preloadParts * kPartSize;
+	if (preloadTill > kInSlice
+		&& tillSlice < _data.size()
+		&& !cacheNotLoaded(tillSlice)) {
+		const auto offsets = _data[tillSlice].offsetsFromLoader(
+			0,
+			std::min(preloadTill - kInSlice, kInSlice));
+		for (const auto offset : offsets.values()) {
+			const auto full = offset + tillSlice * kInSlice;
+			if (full >= _size || !result.offsetsFromLoader.add(full)) {
+				break;
+			}
+		}
+		if (!_data[tillSlice].parts.empty()) {
+			markSliceUsed(tillSlice);
+		}
+	}
 	if (first.ready && second.ready) {
 		markSliceUsed(fromSlice);
 		CopyLoaded(
@@ -639,13 +680,15 @@ auto Reader::Slices::fill(uint32 offset, bytes::span buffer) -> FillResult {
 	return result;
 }
 
-auto Reader::Slices::fillFromHeader(uint32 offset, bytes::span buffer)
--> FillResult {
+auto Reader::Slices::fillFromHeader(
+		uint32 offset,
+		bytes::span buffer,
+		int preloadParts) -> FillResult {
 	auto result = FillResult();
 	const auto from = offset;
 	const auto till = uint32(offset + buffer.size());
 
-	const auto prepared = _header.prepareFill(from, till);
+	const auto prepared = _header.prepareFill(from, till, preloadParts);
 	for (const auto full : prepared.offsetsFromLoader.values()) {
 		if (full < _size) {
 			result.offsetsFromLoader.add(full);
@@ -705,6 +748,32 @@ void Reader::Slices::markSliceUsed(int sliceIndex) {
 	}
 }
 
+bool Reader::Slices::usedSlicesOverBudget() const {
+	const auto count = int(_usedSlices.size());
+	if (count <= kSlicesInMemoryMin) {
+		return false;
+	} else if (count > kSlicesInMemoryMax) {
+		return true;
+	}
+	auto loaded = int64();
+	for (const auto index : _usedSlices) {
+		loaded += int64(_data[index].parts.size()) * kPartSize;
+	}
+	return (loaded > kSlicesMemoryBudget);
+}
+
+int Reader::Slices::chooseSliceToUnload() const {
+	Expects(int(_usedSlices.size()) > kSlicesInMemoryMin);
+
+	// Least recently used, but never the slice being read right now
+	// or the one right after it, where the readahead goes.
+	const auto current = _usedSlices.back();
+	const auto i = ranges::find_if(_usedSlices, [&](int index) {
+		return (index != current) && (index != current + 1);
+	});
+	return (i != end(_usedSlices)) ? *i : _usedSlices.front();
+}
+
 int Reader::Slices::maxSliceSize(int sliceNumber) const {
 	return MaxSliceSize(sliceNumber, _size);
 }
@@ -712,12 +781,11 @@ int Reader::Slices::maxSliceSize(int sliceNumber) const {
 Reader::SerializedSlice Reader::Slices::serializeAndUnloadUnused() {
 	using Flag = Slice::Flag;
 
-	if (_headerMode == HeaderMode::Unknown
-		|| _usedSlices.size() <= kSlicesInMemory) {
+	if (_headerMode == HeaderMode::Unknown || !usedSlicesOverBudget()) {
 		return {};
 	}
-	const auto purgeSlice = _usedSlices.front();
-	_usedSlices.pop_front();
+	const auto purgeSlice = chooseSliceToUnload();
+	_usedSlices.erase(ranges::find(_usedSlices, purgeSlice));
 	if (!(_data[purgeSlice].flags & Flag::LoadedFromCache)) {
 		// If the only data in this slice was from _header, just leave it.
 		return {};
@@ -843,8 +911,15 @@ Reader::Reader(
 	Storage::Cache::Database *cache)
 : _loader(std::move(loader))
 , _cache(cache)
-, _cacheHelper(cache ? InitCacheHelper(_loader->baseCacheKey()) : nullptr)
-, _slices(_loader->size(), _cacheHelper != nullptr) {
+, _direct(_loader->directReadSupported())
+, _cacheHelper((cache && !_direct)
+	? InitCacheHelper(_loader->baseCacheKey())
+	: nullptr)
+, _slices(_loader->size(), _cacheHelper != nullptr)
+, _preloadParts(kPreloadPartsAhead) {
+	if (_direct) {
+		return;
+	}
 	_loader->parts(
 	) | rpl::start_with_next([=](LoadedPart &&part) {
 		if (_attachedDownloader) {
@@ -1213,6 +1288,20 @@ bool Reader::fullInCache() const {
 	return _slices.fullInCache();
 }
 
+void Reader::setBitrate(int64 bytesPerSecond) {
+	_bitrate = bytesPerSecond;
+	_preloadParts = computePreloadParts();
+}
+
+ReadingStats Reader::stats() const {
+	return {
+		.stalls = _stalls.load(std::memory_order_relaxed),
+		.stalledTime = _stalledTime.load(std::memory_order_relaxed),
+		.downloadSpeed = _downloadSpeed.load(std::memory_order_relaxed),
+		.preloadParts = _preloadParts.load(std::memory_order_relaxed),
+	};
+}
+
 Reader::FillState Reader::fill(
 		int64 offset,
 		bytes::span buffer,
@@ -1242,6 +1331,14 @@ Reader::FillState Reader::fill(
 		return FillState::Failed;
 	};
 
+	if (_direct) {
+		if (!_loader->readDirect(offset, buffer)) {
+			_streamingError = Error::LoadFailed;
+			return FillState::Failed;
+		}
+		return FillState::Success;
+	}
+
 	checkForSomethingMoreReceived();
 	if (_streamingError) {
 		return FillState::Failed;
@@ -1251,18 +1348,78 @@ Reader::FillState Reader::fill(
 	do {
 		lastResult = fillFromSlices(uint32(offset), buffer);
 		if (lastResult == FillState::Success) {
+			finishStall();
 			return done();
 		}
 		startWaiting();
 	} while (checkForSomethingMoreReceived());
 
+	if (lastResult == FillState::WaitingRemote) {
+		startStall();
+	}
 	return _streamingError ? failed() : lastResult;
 }
 
+void Reader::startStall() {
+	// Waiting for the header is the initial loading, not a stall.
+	if (!_stallStarted && !_slices.headerModeUnknown()) {
+		_stallStarted = crl::now();
+	}
+}
+
+void Reader::finishStall() {
+	if (!_stallStarted) {
+		return;
+	}
+	const auto duration = crl::now() - base::take(_stallStarted);
+	const auto stalls = ++_stalls;
+	_stalledTime += duration;
+	DEBUG_LOG(("Streaming Info: Stall #%1 for %2ms, "
+		"speed %3 bytes/s, bitrate %4 bytes/s, readahead %5 parts."
+		).arg(stalls
+		).arg(duration
+		).arg(_downloadSpeed.load()
+		).arg(_bitrate
+		).arg(_preloadParts.load()));
+}
+
+int Reader::computePreloadParts() const {
+	const auto partsFor = [](int64 bytesPerSecond) {
+		const auto bytes = bytesPerSecond * kPreloadAheadTime / 1000;
+		return int(std::min(
+			(bytes + kPartSize - 1) / kPartSize,
+			int64(kPreloadPartsAheadMax)));
+	};
+	if (_bitrate <= 0) {
+		return kPreloadPartsAhead;
+	}
+	auto result = partsFor(_bitrate);
+	if (const auto speed = _downloadSpeed.load()) {
+		// Don't request more than we can download in the same time.
+		result = std::min(result, partsFor(speed));
+	}
+	return std::clamp(result, kPreloadPartsAhead, kPreloadPartsAheadMax);
+}
+
+void Reader::accumulateDownloadSpeed(int64 bytes) {
+	_speedWindowBytes += bytes;
+	const auto now = crl::now();
+	const auto passed = now - _speedWindowStart;
+	if (passed < kDownloadSpeedWindow) {
+		return;
+	}
+	const auto measured = _speedWindowBytes * 1000 / passed;
+	const auto previous = _downloadSpeed.load();
+	_downloadSpeed = previous ? ((previous * 3 + measured) / 4) : measured;
+	_speedWindowStart = now;
+	_speedWindowBytes = 0;
+	_preloadParts = computePreloadParts();
+}
+
 Reader::FillState Reader::fillFromSlices(uint32 offset, bytes::span buffer) {
 	using namespace rpl::mappers;
 
-	auto result = _slices.fill(offset, buffer);
+	auto result = _slices.fill(offset, buffer, _preloadParts.load());
 	if (result.state != FillState::Success && _slices.headerWontBeFilled()) {
 		_streamingError = Error::NotStreamable;
 		return FillState::Failed;
@@ -1359,6 +1516,7 @@ bool Reader::processLoadedParts() {
 		} else if (!_loadingOffsets.remove(part.offset)) {
 			continue;
 		}
+		accumulateDownloadSpeed(part.bytes.size());
 		_slices.processPart(
 			part.offset,
 			std::move(part.bytes));
@@ -1373,6 +1531,11 @@ bool Reader::checkForSomethingMoreReceived() {
 }
 
 void Reader::loadAtOffset(uint32 offset) {
+	if (_loadingOffsets.empty()) {
+		// Measure the speed only while something is being loaded.
+		_speedWindowStart = crl::now();
+		_speedWindowBytes = 0;
+	}
 	if (_loadingOffsets.add(offset)) {
 		_loader->load(offset);
 	}
@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "media/streaming/media_streaming_common.h"
 #include "media/streaming/media_streaming_loader.h"
 #include "base/bytes.h"
 #include "base/weak_ptr.h"
@@ -59,6 +60,10 @@ public:
 	void headerDone();
 	[[nodiscard]] int headerSize() const;
 	[[nodiscard]] bool fullInCache() const;
+	void setBitrate(int64 bytesPerSecond);
+
+	// Any thread.
+	[[nodiscard]] ReadingStats stats() const;
 
 	// Thread safe.
 	void startSleep(not_null<crl::semaphore*> wake);
@@ -82,7 +87,8 @@ public:
 	~Reader();
 
 private:
-	static constexpr auto kLoadFromRemoteMax = 8;
+	// Enough for the largest readahead plus the parts being read.
+	static constexpr auto kLoadFromRemoteMax = 40;
 
 	struct CacheHelper;
 
@@ -132,7 +138,10 @@ private:
 
 		void processCacheData(PartsMap &&data);
 		void addPart(uint32 offset, QByteArray bytes);
-		PrepareFillResult prepareFill(uint32 from, uint32 till);
+		PrepareFillResult prepareFill(
+			uint32 from,
+			uint32 till,
+			int preloadParts);
 
 		// Get up to kLoadFromRemoteMax not loaded parts in from-till range.
 		StackIntVector<kLoadFromRemoteMax> offsetsFromLoader(
@@ -163,7 +172,10 @@ private:
 		void processCachedSizes(const std::vector<int> &sizes);
 		void processPart(uint32 offset, QByteArray &&bytes);
 
-		[[nodiscard]] FillResult fill(uint32 offset, bytes::span buffer);
+		[[nodiscard]] FillResult fill(
+			uint32 offset,
+			bytes::span buffer,
+			int preloadParts);
 		[[nodiscard]] SerializedSlice unloadToCache();
 
 		[[nodiscard]] QByteArray partForDownloader(uint32 offset) const;
@@ -187,10 +199,13 @@ private:
 			const Slice &slice) const;
 		[[nodiscard]] QByteArray serializeAndUnloadFirstSliceNoHeader();
 		void markSliceUsed(int sliceIndex);
+		[[nodiscard]] bool usedSlicesOverBudget() const;
+		[[nodiscard]] int chooseSliceToUnload() const;
 		[[nodiscard]] bool computeIsGoodHeader() const;
 		[[nodiscard]] FillResult fillFromHeader(
 			uint32 offset,
-			bytes::span buffer);
+			bytes::span buffer,
+			int preloadParts);
 		void unloadSlice(Slice &slice) const;
 		void checkSliceFullLoaded(int sliceNumber);
 		[[nodiscard]] bool checkFullInCache() const;
@@ -215,6 +230,10 @@ private:
 	void loadAtOffset(uint32 offset);
 	void checkLoadWillBeFirst(uint32 offset);
 	bool processLoadedParts();
+	void accumulateDownloadSpeed(int64 bytes);
+	[[nodiscard]] int computePreloadParts() const;
+	void startStall();
+	void finishStall();
 
 	bool checkForSomethingMoreReceived();
 
@@ -240,6 +259,9 @@ private:
 	const std::unique_ptr<Loader> _loader;
 	Storage::Cache::Database * const _cache = nullptr;
 
+	// If the whole file is available we read it without slices.
+	const bool _direct = false;
+
 	// shared_ptr is used to be able to have weak_ptr.
 	const std::shared_ptr<CacheHelper> _cacheHelper;
 
@@ -254,6 +276,18 @@ private:
 	// Even if streaming had failed, the Reader can work for the downloader.
 	std::optional<Error> _streamingError;
 
+	// Streaming thread, used to choose how much to read ahead.
+	int64 _bitrate = 0;
+	int64 _speedWindowBytes = 0;
+	crl::time _speedWindowStart = 0;
+	crl::time _stallStarted = 0;
+
+	// Written in streaming thread, read from any thread.
+	std::atomic<int64> _downloadSpeed = 0;
+	std::atomic<int> _preloadParts = 0;
+	std::atomic<int> _stalls = 0;
+	std::atomic<crl::time> _stalledTime = 0;
+
 	// In case streaming is active both main and streaming threads have work.
 	// In case only downloader is active, all work is done on main thread.
 
@@ -96,6 +96,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QtWidgets/QApplication>
 #include <QtCore/QBuffer>
+#include <QtCore/QFile>
+#include <QtGui/QImageReader>
 #include <QtGui/QGuiApplication>
 #include <QtGui/QWindow>
 #include <QtGui/QScreen>
@@ -108,6 +110,7 @@ namespace View {
 namespace {
 
 constexpr auto kPreloadCount = 3;
+constexpr auto kPredecodeBytesLimit = 64 * 1024 * 1024;
 constexpr auto kMaxZoomLevel = 7; // x8
 constexpr auto kZoomToScreenLevel = 1024;
 constexpr auto kOverlayLoaderPriority = 2;
@@ -125,6 +128,13 @@ constexpr auto kIdsPreloadAfter = 28;
 
 constexpr auto kLeftSiblingTextureIndex = 1;
 constexpr auto kRightSiblingTextureIndex = 2;
+
+// Visible parts of huge images are decoded in full resolution separately.
+// Stories never have those, so their sibling textures are reused for them.
+constexpr auto kStaticDetailTextureIndex = 1;
+constexpr auto kStaticDetailParts = 2;
+constexpr auto kStaticDetailTileSize = 256;
+constexpr auto kStaticDetailMaxPixels = 4096 * 4096;
 constexpr auto kStoriesControlsOpacity = 1.;
 constexpr auto kStorySavePromoDuration = 3 * crl::time(1000);
 
@@ -204,6 +214,46 @@ QWidget *PipDelegate::pipParentWidget() {
 		: read.image;
 }
 
+[[nodiscard]] std::unique_ptr<QIODevice> OpenImageDevice(
+		const QString &path,
+		const QByteArray &bytes) {
+	auto result = std::unique_ptr<QIODevice>();
+	if (!path.isEmpty()) {
+		result = std::make_unique<QFile>(path);
+	} else {
+		auto buffer = std::make_unique<QBuffer>();
+		buffer->setData(bytes);
+		result = std::move(buffer);
+	}
+	return result->open(QIODevice::ReadOnly) ? std::move(result) : nullptr;
+}
+
+[[nodiscard]] QImage ReadImageRegion(
+		const QString &path,
+		const QByteArray &bytes,
+		QRect region,
+		int shift) {
+	const auto device = OpenImageDevice(path, bytes);
+	if (!device) {
+		return QImage();
+	}
+	auto reader = QImageReader(device.get());
+	reader.setAutoTransform(false);
+	reader.setClipRect(region);
+	reader.setScaledSize(QSize(
+		std::max(region.width() >> shift, 1),
+		std::max(region.height() >> shift, 1)));
+	auto result = QImage();
+	if (!reader.read(&result)) {
+		return QImage();
+	}
+	constexpr auto kGood = QImage::Format_ARGB32_Premultiplied;
+	return (result.format() != kGood
+		&& result.format() != QImage::Format_RGB32)
+		? std::move(result).convertToFormat(kGood)
+		: result;
+}
+
 [[nodiscard]] bool IsSemitransparent(const QImage &image) {
 	if (image.isNull()) {
 		return true;
@@ -269,6 +319,23 @@ struct OverlayWidget::Streamed {
 	bool resumeOnCallEnd = false;
 };
 
+struct OverlayWidget::StaticDetail {
+	struct Part {
+		QImage image;
+		QRect region;
+		int shift = 0;
+		uint64 stamp = 0;
+	};
+
+	QString path;
+	QByteArray bytes;
+	QSize original;
+	std::vector<Part> parts;
+	uint64 stamp = 0;
+	uint64 requestId = 0;
+	bool requesting = false;
+};
+
 struct OverlayWidget::PipWrap {
 	PipWrap(
 		QWidget *parent,
@@ -1137,6 +1204,161 @@ void OverlayWidget::setStaticContent(QImage image) {
 	image.setDevicePixelRatio(style::DevicePixelRatio());
 	_staticContent = std::move(image);
 	_staticContentTransparent = IsSemitransparent(_staticContent);
+	_staticDetail = nullptr;
+}
+
+void OverlayWidget::initStaticDetail(
+		const QString &path,
+		const QByteArray &bytes) {
+	_staticDetail = nullptr;
+	if (_stories || _staticContent.isNull() || _staticContentTransparent) {
+		return;
+	}
+	const auto device = OpenImageDevice(path, bytes);
+	if (!device) {
+		return;
+	}
+	auto reader = QImageReader(device.get());
+	const auto original = reader.size();
+
+	// Without native clip rect support (f.e. PNG or WebP) each tile
+	// request would decode the whole image, so no detail parts then.
+	if ((original.width() <= _staticContent.width()
+		&& original.height() <= _staticContent.height())
+		|| reader.transformation() != QImageIOHandler::TransformationNone
+		|| !reader.supportsOption(QImageIOHandler::ClipRect)) {
+		return;
+	}
+	_staticDetail = std::make_unique<StaticDetail>(StaticDetail{
+		.path = path,
+		.bytes = path.isEmpty() ? bytes : QByteArray(),
+		.original = original,
+	});
+}
+
+void OverlayWidget::paintStaticDetail(
+		not_null<Renderer*> renderer,
+		const ContentGeometry &geometry) {
+	Expects(_staticDetail != nullptr);
+
+	const auto detail = _staticDetail.get();
+	const auto rect = geometry.rect;
+	const auto shown = rect.width() * style::DevicePixelRatio();
+	if (geometry.rotation != 0.
+		|| _geometryAnimation.animating()
+		|| shown <= _staticContent.width()) {
+		return;
+	}
+	const auto visible = rect.intersected(QRectF(_widget->rect()));
+	if (visible.isEmpty()) {
+		return;
+	}
+	const auto original = detail->original;
+	const auto scale = original.width() / rect.width();
+	const auto source = QRectF(
+		(visible.x() - rect.x()) * scale,
+		(visible.y() - rect.y()) * scale,
+		visible.width() * scale,
+		visible.height() * scale
+	).toAlignedRect().intersected(QRect(QPoint(), original));
+	if (source.isEmpty()) {
+		return;
+	}
+
+	// Decode the least pixels that still cover the shown ones.
+	auto shift = 0;
+	while ((original.width() >> (shift + 1)) >= shown
+		|| (int64(source.width() >> shift) * (source.height() >> shift)
+			> kStaticDetailMaxPixels)) {
+		++shift;
+	}
+	const auto covered = ranges::any_of(detail->parts, [&](
+			const StaticDetail::Part &part) {
+		return (part.shift == shift) && part.region.contains(source);
+	});
+	if (!covered && !detail->requesting) {
+		const auto step = kStaticDetailTileSize << shift;
+		const auto left = (source.x() / step) * step;
+		const auto top = (source.y() / step) * step;
+		const auto right = std::min(
+			((source.x() + source.width() + step - 1) / step) * step,
+			original.width());
+		const auto bottom = std::min(
+			((source.y() + source.height() + step - 1) / step) * step,
+			original.height());
+		requestStaticDetail(
+			QRect(left, top, right - left, bottom - top),
+			shift);
+	}
+
+	// Paint coarser parts first, so that the sharpest one ends up on top.
+	auto order = std::vector<int>();
+	for (auto i = 0, count = int(detail->parts.size()); i != count; ++i) {
+		if (detail->parts[i].shift >= shift) {
+			order.push_back(i);
+		}
+	}
+	ranges::sort(order, [&](int a, int b) {
+		const auto &first = detail->parts[a];
+		const auto &second = detail->parts[b];
+		return (first.shift != second.shift)
+			? (first.shift > second.shift)
+			: (first.stamp < second.stamp);
+	});
+	for (const auto index : order) {
+		const auto &part = detail->parts[index];
+		auto partGeometry = geometry;
+		partGeometry.rect = QRectF(
+			rect.x() + part.region.x() / scale,
+			rect.y() + part.region.y() / scale,
+			part.region.width() / scale,
+			part.region.height() / scale);
+		if (!partGeometry.rect.intersects(visible)) {
+			continue;
+		}
+		renderer->paintTransformedStaticContent(
+			part.image,
+			partGeometry,
+			false, // semi-transparent
+			false, // fill transparent background
+			kStaticDetailTextureIndex + index);
+	}
+}
+
+void OverlayWidget::requestStaticDetail(QRect region, int shift) {
+	Expects(_staticDetail != nullptr);
+
+	const auto detail = _staticDetail.get();
+	const auto id = detail->requestId = base::RandomValue<uint64>();
+	const auto weak = Ui::MakeWeak(_widget);
+	detail->requesting = true;
+	crl::async([=, path = detail->path, bytes = detail->bytes] {
+		auto image = ReadImageRegion(path, bytes, region, shift);
+		crl::on_main(weak, [=, image = std::move(image)]() mutable {
+			const auto detail = _staticDetail.get();
+			if (!detail || detail->requestId != id) {
+				return;
+			} else if (image.isNull()) {
+				_staticDetail = nullptr;
+				return;
+			}
+			detail->requesting = false;
+			auto &parts = detail->parts;
+			const auto part = (int(parts.size()) < kStaticDetailParts)
+				? &parts.emplace_back()
+				: &*ranges::min_element(
+					parts,
+					ranges::less(),
+					&StaticDetail::Part::stamp);
+			*part = StaticDetail::Part{
+				.image = std::move(image),
+				.region = region,
+				.shift = shift,
+				.stamp = ++detail->stamp,
+			};
+			update();
+		});
+	});
 }
 
 bool OverlayWidget::contentShown() const {
@@ -3479,6 +3701,7 @@ void OverlayWidget::displayPhoto(
 	refreshMediaViewer();
 
 	_staticContent = QImage();
+	_staticDetail = nullptr;
 	if (!_stories && _photo->videoCanBePlayed()) {
 		initStreaming();
 	}
@@ -3534,6 +3757,7 @@ void OverlayWidget::displayDocument(
 		const StartStreaming &startStreaming) {
 	_fullScreenVideo = false;
 	_staticContent = QImage();
+	_staticDetail = nullptr;
 	clearStreaming(_document != doc);
 	destroyThemePreview();
 	assignMediaPointer(doc);
@@ -3575,6 +3799,7 @@ void OverlayWidget::displayDocument(
 					setStaticContent(PrepareStaticImage({
 						.path = location.name(),
 					}));
+					initStaticDetail(location.name(), QByteArray());
 					if (!_staticContent.isNull()) {
 						_touchbarDisplay.fire(TouchBarItemType::Photo);
 					}
@@ -3582,6 +3807,7 @@ void OverlayWidget::displayDocument(
 					setStaticContent(PrepareStaticImage({
 						.content = _documentMedia->bytes(),
 					}));
+					initStaticDetail(QString(), _documentMedia->bytes());
 					if (!_staticContent.isNull()) {
 						_touchbarDisplay.fire(TouchBarItemType::Photo);
 					}
@@ -3863,7 +4089,9 @@ void OverlayWidget::initStreamingThumbnail() {
 	}
 	const auto options = VideoThumbOptions(_document);
 	const auto goodOptions = (options & ~Images::Option::Blur);
-	setStaticContent((good
+	auto ready = good ? predecoded(good, size) : QImage();
+	const auto fromCache = !ready.isNull();
+	setStaticContent(fromCache ? std::move(ready) : (good
 		? good
 		: thumbnail
 		? thumbnail
@@ -3876,6 +4104,9 @@ void OverlayWidget::initStreamingThumbnail() {
 				.outer = size / style::DevicePixelRatio(),
 			}
 		).toImage());
+	if (good) {
+		sharpFrameShown(fromCache);
+	}
 }
 
 void OverlayWidget::streamingReady(Streaming::Information &&info) {
@@ -4611,11 +4842,121 @@ void OverlayWidget::validatePhotoImage(Image *image, bool blurred) {
 	}
 	const auto use = flipSizeByRotation({ _width, _height })
 		* style::DevicePixelRatio();
-	setStaticContent(image->pixNoCache(
+	auto ready = blurred ? QImage() : predecoded(image, use);
+	const auto fromCache = !ready.isNull();
+	setStaticContent(fromCache ? std::move(ready) : image->pixNoCache(
 		use,
 		{ .options = (blurred ? Images::Option::Blur : Images::Option()) }
 	).toImage());
 	_blurred = blurred;
+	if (!blurred) {
+		sharpFrameShown(fromCache);
+	}
+}
+
+QImage OverlayWidget::predecoded(not_null<Image*> image, QSize size) const {
+	const auto i = _predecoded.find(image->original().cacheKey());
+	return (i != end(_predecoded) && i->second.size == size)
+		? i->second.image
+		: QImage();
+}
+
+void OverlayWidget::predecodeNeighbours() {
+	if (!_index || _stories) {
+		_predecoded.clear();
+		return;
+	}
+	const auto ratio = style::DevicePixelRatio();
+	const auto weak = Ui::MakeWeak(_widget);
+	auto result = base::flat_map<qint64, Predecoded>();
+	auto left = int64(kPredecodeBytesLimit);
+	const auto add = [&](
+			not_null<Image*> image,
+			QSize size,
+			Images::PrepareArgs args,
+			bool start) {
+		const auto bytes = int64(size.width()) * size.height() * 4;
+		if (size.isEmpty() || bytes > left) {
+			return;
+		}
+		const auto key = image->original().cacheKey();
+		const auto i = _predecoded.find(key);
+		if (i != end(_predecoded) && i->second.size == size) {
+			left -= bytes;
+			result.emplace(key, std::move(i->second));
+			return;
+		} else if (!start) {
+			return;
+		}
+		left -= bytes;
+		result.emplace(key, Predecoded{ .size = size });
+		crl::async([=, original = image->original()] {
+			constexpr auto kGood = QImage::Format_ARGB32_Premultiplied;
+			auto prepared = Images::Prepare(original, size, args);
+			if (prepared.format() != kGood
+				&& prepared.format() != QImage::Format_RGB32) {
+				prepared = std::move(prepared).convertToFormat(kGood);
+			}
+			crl::on_main(weak, [=, prepared = std::move(prepared)]() mutable {
+				const auto i = _predecoded.find(key);
+				if (i != end(_predecoded)
+					&& i->second.size == size
+					&& i->second.image.isNull()) {
+					i->second.image = std::move(prepared);
+				}
+			});
+		});
+	};
+
+	const auto predecode = [&](int index, bool start) {
+		const auto entity = entityByIndex(index);
+		if (const auto photo = std::get_if<not_null<PhotoData*>>(
+				&entity.data)) {
+			const auto media = (*photo)->activeMediaView();
+			const auto large = media
+				? media->image(Data::PhotoSize::Large)
+				: nullptr;
+			if (large) {
+				const auto size = style::ConvertScale(QSize(
+					(*photo)->width(),
+					(*photo)->height()));
+				add(large, size * ratio, {}, start);
+			}
+		} else if (const auto document = std::get_if<not_null<DocumentData*>>(
+				&entity.data)) {
+			const auto media = (*document)->isVideoFile()
+				? (*document)->activeMediaView()
+				: nullptr;
+			const auto good = media ? media->goodThumbnail() : nullptr;
+			if (good) {
+				const auto options = VideoThumbOptions(*document)
+					& ~Images::Option::Blur;
+				add(good, good->size(), {
+					.options = options,
+					.outer = good->size() / ratio,
+				}, start);
+			}
+		}
+	};
+
+	// The current one is prepared synchronously when painted anyway.
+	// Nearest neighbours go first, so that they fit in the bytes limit.
+	predecode(*_index, false);
+	for (auto distance = 1; distance <= kPreloadCount; ++distance) {
+		predecode(*_index - distance, true);
+		predecode(*_index + distance, true);
+	}
+	_predecoded = std::move(result);
+}
+
+void OverlayWidget::sharpFrameShown(bool predecoded) {
+	if (!_sharpFrameWaitStarted) {
+		return;
+	}
+	DEBUG_LOG(("Media Viewer: Sharp frame in %1 ms (predecoded: %2)."
+		).arg(crl::now() - _sharpFrameWaitStarted
+		).arg(Logs::b(predecoded)));
+	_sharpFrameWaitStarted = 0;
 }
 
 void OverlayWidget::validatePhotoCurrentImage() {
@@ -4661,6 +5002,7 @@ void OverlayWidget::paint(not_null<Renderer*> renderer) {
 			renderer->paintTransformedVideoFrame(contentGeometry());
 			if (_streamed->instance.player().ready()) {
 				_streamed->instance.markFrameShown();
+				sharpFrameShown(false);
 				if (_stories) {
 					_stories->ready();
 				}
@@ -4673,11 +5015,15 @@ void OverlayWidget::paint(not_null<Renderer*> renderer) {
 			const auto fillTransparentBackground = (!_document
 				|| (!_document->sticker() && !_document->isVideoMessage()))
 				&& _staticContentTransparent;
+			const auto geometry = contentGeometry();
 			renderer->paintTransformedStaticContent(
 				_staticContent,
-				contentGeometry(),
+				geometry,
 				_staticContentTransparent,
 				fillTransparentBackground);
+			if (_staticDetail) {
+				paintStaticDetail(renderer, geometry);
+			}
 		}
 		paintRadialLoading(renderer);
 		if (_stories) {
@@ -5538,6 +5884,7 @@ void OverlayWidget::setSession(not_null<Main::Session*> session) {
 		if (!isHidden()) {
 			updateControls();
 			checkForSaveLoaded();
+			predecodeNeighbours();
 		}
 	}, _sessionLifetime);
 
@@ -5590,6 +5937,7 @@ bool OverlayWidget::moveToEntity(const Entity &entity, int preloadDelta) {
 	}
 	clearStreaming();
 	_streamingStartPaused = false;
+	_sharpFrameWaitStarted = crl::now();
 	if (auto photo = std::get_if<not_null<PhotoData*>>(&entity.data)) {
 		displayPhoto(*photo);
 	} else if (auto document = std::get_if<not_null<DocumentData*>>(&entity.data)) {
@@ -5629,6 +5977,7 @@ void OverlayWidget::preloadData(int delta) {
 	}
 	_preloadPhotos = std::move(photos);
 	_preloadDocuments = std::move(documents);
+	predecodeNeighbours();
 }
 
 void OverlayWidget::handleMousePress(
@@ -6288,6 +6637,7 @@ void OverlayWidget::clearBeforeHide() {
 	assignMediaPointer(nullptr);
 	_preloadPhotos.clear();
 	_preloadDocuments.clear();
+	_predecoded.clear();
 	if (_menu) {
 		_menu->hideMenu(true);
 	}
@@ -6307,6 +6657,7 @@ void OverlayWidget::clearAfterHide() {
 	destroyThemePreview();
 	_radial.stop();
 	_staticContent = QImage();
+	_staticDetail = nullptr;
 	_themePreview = nullptr;
 	_themeApply.destroyDelayed();
 	_themeCancel.destroyDelayed();
@@ -140,6 +140,7 @@ private:
 	struct PipWrap;
 	struct ItemContext;
 	struct StoriesContext;
+	struct StaticDetail;
 	class Renderer;
 	class RendererSW;
 	class RendererGL;
@@ -496,6 +497,9 @@ private:
 	void initGroupThumbs();
 
 	void validatePhotoImage(Image *image, bool blurred);
+	[[nodiscard]] QImage predecoded(not_null<Image*> image, QSize size) const;
+	void predecodeNeighbours();
+	void sharpFrameShown(bool predecoded);
 	void validatePhotoCurrentImage();
 
 	[[nodiscard]] bool hasCopyMediaRestriction(
@@ -520,6 +524,11 @@ private:
 	[[nodiscard]] bool documentContentShown() const;
 	[[nodiscard]] bool documentBubbleShown() const;
 	void setStaticContent(QImage image);
+	void initStaticDetail(const QString &path, const QByteArray &bytes);
+	void paintStaticDetail(
+		not_null<Renderer*> renderer,
+		const ContentGeometry &geometry);
+	void requestStaticDetail(QRect region, int shift);
 	[[nodiscard]] bool contentShown() const;
 	[[nodiscard]] bool opaqueContentShown() const;
 	void clearStreaming(bool savePosition = true);
@@ -557,6 +566,12 @@ private:
 	std::shared_ptr<Data::DocumentMedia> _documentMedia;
 	base::flat_set<std::shared_ptr<Data::PhotoMedia>> _preloadPhotos;
 	base::flat_set<std::shared_ptr<Data::DocumentMedia>> _preloadDocuments;
+	struct Predecoded {
+		QImage image; // Null while still being prepared.
+		QSize size;
+	};
+	base::flat_map<qint64, Predecoded> _predecoded;
+	crl::time _sharpFrameWaitStarted = 0;
 	int _rotation = 0;
 	std::unique_ptr<SharedMedia> _sharedMedia;
 	std::optional<SharedMediaWithLastSlice> _sharedMediaData;
@@ -616,6 +631,7 @@ private:
 	int32 _dragging = 0;
 	QImage _staticContent;
 	bool _staticContentTransparent = false;
+	std::unique_ptr<StaticDetail> _staticDetail;
 	bool _blurred = true;
 	bool _reShow = false;
 
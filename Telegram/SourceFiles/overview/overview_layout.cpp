@@ -339,11 +339,6 @@ Photo::Photo(
 }) : nullptr)
 , _pinned(options.pinned)
 , _story(options.story) {
-	if (_data->inlineThumbnailBytes().isEmpty()
-		&& (_data->hasExact(Data::PhotoSize::Small)
-			|| _data->hasExact(Data::PhotoSize::Thumbnail))) {
-		_data->load(Data::PhotoSize::Small, parent->fullId());
-	}
 }
 
 Photo::~Photo() = default;
@@ -466,6 +461,14 @@ void Photo::itemDataChanged() {
 	}
 }
 
+void Photo::preloadHeavyPart() {
+	if (_data->inlineThumbnailBytes().isEmpty()
+		&& (_data->hasExact(Data::PhotoSize::Small)
+			|| _data->hasExact(Data::PhotoSize::Thumbnail))) {
+		_data->load(Data::PhotoSize::Small, parent()->fullId());
+	}
+}
+
 void Photo::clearHeavyPart() {
 	_dataMedia = nullptr;
 }
@@ -493,7 +496,6 @@ Video::Video(
 , _pinned(options.pinned)
 , _story(options.story) {
 	setDocumentLinks(_data);
-	_data->loadThumbnail(parent->fullId());
 }
 
 Video::~Video() = default;
@@ -651,6 +653,10 @@ void Video::itemDataChanged() {
 	}
 }
 
+void Video::preloadHeavyPart() {
+	_data->loadThumbnail(parent()->fullId());
+}
+
 void Video::clearHeavyPart() {
 	_dataMedia = nullptr;
 }
@@ -2005,7 +2011,6 @@ Gif::Gif(
 : RadialProgressItem(delegate, parent)
 , _data(gif) {
 	setDocumentLinks(_data, true);
-	_data->loadThumbnail(parent->fullId());
 }
 
 Gif::~Gif() = default;
@@ -2249,6 +2254,10 @@ void Gif::ensureDataMediaCreated() const {
 	delegate()->registerHeavyItem(this);
 }
 
+void Gif::preloadHeavyPart() {
+	_data->loadThumbnail(parent()->fullId());
+}
+
 void Gif::clearHeavyPart() {
 	_gif.reset();
 	_dataMedia = nullptr;
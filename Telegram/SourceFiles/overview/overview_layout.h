@@ -73,6 +73,8 @@ public:
 
 	virtual void itemDataChanged() {
 	}
+	virtual void preloadHeavyPart() {
+	}
 	virtual void clearHeavyPart() {
 	}
 
@@ -208,6 +210,7 @@ public:
 		StateRequest request) const override;
 
 	void itemDataChanged() override;
+	void preloadHeavyPart() override;
 	void clearHeavyPart() override;
 
 private:
@@ -246,6 +249,7 @@ public:
 		QPoint point,
 		StateRequest request) const override;
 
+	void preloadHeavyPart() override;
 	void clearHeavyPart() override;
 	void setPosition(int32 position) override;
 
@@ -302,6 +306,7 @@ public:
 		StateRequest request) const override;
 
 	void itemDataChanged() override;
+	void preloadHeavyPart() override;
 	void clearHeavyPart() override;
 	void clearSpoiler() override;
 
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/options.h"
 #include "base/platform/base_platform_info.h"
 #include "base/platform/linux/base_linux_dbus_utilities.h"
+#include "base/timer.h"
 #include "core/application.h"
 #include "core/sandbox.h"
 #include "core/core_settings.h"
@@ -29,6 +30,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <xdgnotifications/xdgnotifications.hpp>
 
 #include <dlfcn.h>
+#include <deque>
 
 namespace Platform {
 namespace Notifications {
@@ -40,6 +42,10 @@ namespace GObject = gi::repository::GObject;
 constexpr auto kService = "org.freedesktop.Notifications";
 constexpr auto kObjectPath = "/org/freedesktop/Notifications";
 
+// Bursts (f.e. after reconnect) are sent to the daemon in small portions.
+constexpr auto kSendWindow = crl::time(1000);
+constexpr auto kMaxSendsPerWindow = 8;
+
 struct ServerInformation {
 	std::string name;
 	std::string vendor;
@@ -188,7 +194,10 @@ public:
 
 	void show();
 	void close();
-	void setImage(QImage image);
+	void setImage(QImage image, Fn<void()> ready);
+
+	[[nodiscard]] bool imageReady() const;
+	[[nodiscard]] bool shown() const;
 
 private:
 	const not_null<Manager*> _manager;
@@ -205,6 +214,8 @@ private:
 	std::vector<std::string> _actions;
 	GLib::VariantDict _hints;
 	std::string _imageKey;
+	bool _imageReady = true;
+	bool _shown = false;
 
 	uint _notificationId = 0;
 	ulong _actionInvokedSignalId = 0;
@@ -439,6 +450,7 @@ NotificationData::~NotificationData() {
 }
 
 void NotificationData::show() {
+	_shown = true;
 	if (_application && _notification) {
 		_application.send_notification(_guid, _notification);
 		return;
@@ -495,55 +507,79 @@ void NotificationData::show() {
 }
 
 void NotificationData::close() {
-	if (_application) {
-		_application.withdraw_notification(_guid);
-	} else {
-		_interface.call_close_notification(_notificationId, nullptr);
+	if (_shown) {
+		if (_application) {
+			_application.withdraw_notification(_guid);
+		} else {
+			_interface.call_close_notification(_notificationId, nullptr);
+		}
 	}
 	_manager->clearNotification(_id);
 }
 
-void NotificationData::setImage(QImage image) {
-	if (_notification) {
-		const auto imageData = std::make_shared<QByteArray>();
-		QBuffer buffer(imageData.get());
-		buffer.open(QIODevice::WriteOnly);
-		image.save(&buffer, "PNG");
-
-		_notification.set_icon(
-			Gio::BytesIcon::new_(
-				GLib::Bytes::new_with_free_func(
-					reinterpret_cast<const uchar*>(imageData->constData()),
-					imageData->size(),
-					[imageData] {})));
+bool NotificationData::imageReady() const {
+	return _imageReady;
+}
 
-		return;
-	}
+bool NotificationData::shown() const {
+	return _shown;
+}
 
-	if (_imageKey.empty()) {
+void NotificationData::setImage(QImage image, Fn<void()> ready) {
+	const auto encodePng = bool(_notification);
+	if (!encodePng && _imageKey.empty()) {
+		ready();
 		return;
 	}
 
-	if (image.hasAlphaChannel()) {
-		image.convertTo(QImage::Format_RGBA8888);
-	} else {
-		image.convertTo(QImage::Format_RGB888);
-	}
-
-	_hints.insert_value(_imageKey, GLib::Variant::new_tuple({
-		GLib::Variant::new_int32(image.width()),
-		GLib::Variant::new_int32(image.height()),
-		GLib::Variant::new_int32(image.bytesPerLine()),
-		GLib::Variant::new_boolean(image.hasAlphaChannel()),
-		GLib::Variant::new_int32(8),
-		GLib::Variant::new_int32(image.hasAlphaChannel() ? 4 : 3),
-		GLib::Variant::new_from_data(
-			GLib::VariantType::new_("ay"),
-			reinterpret_cast<const uchar*>(image.constBits()),
-			image.sizeInBytes(),
-			true,
-			[image] {}),
-	}));
+	// Encoding and pixel format conversion are done on a worker,
+	// the notification is held back by the manager until it's done.
+	_imageReady = false;
+	const auto weak = base::make_weak(this);
+	crl::async([=, image = std::move(image)]() mutable {
+		auto png = QByteArray();
+		if (encodePng) {
+			QBuffer buffer(&png);
+			buffer.open(QIODevice::WriteOnly);
+			image.save(&buffer, "PNG");
+			image = QImage();
+		} else if (image.hasAlphaChannel()) {
+			image.convertTo(QImage::Format_RGBA8888);
+		} else {
+			image.convertTo(QImage::Format_RGB888);
+		}
+		crl::on_main(weak, [=, png = std::move(png)]() mutable {
+			_imageReady = true;
+			if (encodePng) {
+				const auto imageData = std::make_shared<QByteArray>(
+					std::move(png));
+				_notification.set_icon(
+					Gio::BytesIcon::new_(
+						GLib::Bytes::new_with_free_func(
+							reinterpret_cast<const uchar*>(
+								imageData->constData()),
+							imageData->size(),
+							[imageData] {})));
+			} else {
+				_hints.insert_value(_imageKey, GLib::Variant::new_tuple({
+					GLib::Variant::new_int32(image.width()),
+					GLib::Variant::new_int32(image.height()),
+					GLib::Variant::new_int32(image.bytesPerLine()),
+					GLib::Variant::new_boolean(image.hasAlphaChannel()),
+					GLib::Variant::new_int32(8),
+					GLib::Variant::new_int32(
+						image.hasAlphaChannel() ? 4 : 3),
+					GLib::Variant::new_from_data(
+						GLib::VariantType::new_("ay"),
+						reinterpret_cast<const uchar*>(image.constBits()),
+						image.sizeInBytes(),
+						true,
+						[image] {}),
+				}));
+			}
+			ready();
+		});
+	});
 }
 
 } // namespace
@@ -574,12 +610,21 @@ public:
 	~Private();
 
 private:
+	[[nodiscard]] NotificationData *lookup(NotificationId id) const;
+	void sendPending();
+	void pendingRemoved();
+
 	const not_null<Manager*> _manager;
 
 	base::flat_map<
 		ContextId,
 		base::flat_map<MsgId, Notification>> _notifications;
 
+	std::deque<NotificationId> _pending;
+	base::Timer _sendTimer;
+	crl::time _sendWindowStart = 0;
+	int _sentInWindow = 0;
+
 	XdgNotifications::NotificationsProxy _proxy;
 	XdgNotifications::Notifications _interface;
 
@@ -738,7 +783,8 @@ void Create(Window::Notifications::System *system) {
 }
 
 Manager::Private::Private(not_null<Manager*> manager)
-: _manager(manager) {
+: _manager(manager)
+, _sendTimer([=] { sendPending(); }) {
 	const auto &serverInformation = CurrentServerInformation;
 
 	if (!serverInformation.name.empty()) {
@@ -810,7 +856,8 @@ void Manager::Private::showNotification(
 
 	if (!options.hideNameAndPhoto) {
 		notification->setImage(
-			Window::Notifications::GenerateUserpic(peer, userpicView));
+			Window::Notifications::GenerateUserpic(peer, userpicView),
+			crl::guard(this, [=] { sendPending(); }));
 	}
 
 	auto i = _notifications.find(key);
@@ -827,11 +874,60 @@ void Manager::Private::showNotification(
 		i = _notifications.emplace(
 			key,
 			base::flat_map<MsgId, Notification>()).first;
+	} else {
+		// Coalesce: a newer message in the same thread supersedes
+		// the ones still waiting to be sent to the daemon.
+		for (auto j = begin(i->second); j != end(i->second);) {
+			if (j->second->shown()) {
+				++j;
+			} else {
+				j = i->second.erase(j);
+			}
+		}
+	}
+	i->second.emplace(msgId, std::move(notification));
+	_pending.push_back(notificationId);
+	sendPending();
+}
+
+NotificationData *Manager::Private::lookup(NotificationId id) const {
+	const auto i = _notifications.find(id.contextId);
+	if (i == end(_notifications)) {
+		return nullptr;
+	}
+	const auto j = i->second.find(id.msgId);
+	return (j != end(i->second)) ? j->second.get() : nullptr;
+}
+
+void Manager::Private::pendingRemoved() {
+	// The removed one could be the queue head waiting for its image.
+	if (!_pending.empty() && !_sendTimer.isActive()) {
+		_sendTimer.callOnce(0);
+	}
+}
+
+void Manager::Private::sendPending() {
+	const auto now = crl::now();
+	if (now - _sendWindowStart >= kSendWindow) {
+		_sendWindowStart = now;
+		_sentInWindow = 0;
+	}
+	while (!_pending.empty()) {
+		const auto notification = lookup(_pending.front());
+		if (!notification || notification->shown()) {
+			_pending.pop_front();
+			continue;
+		} else if (!notification->imageReady()) {
+			// Keep the order, we'll be called again when it is ready.
+			return;
+		} else if (_sentInWindow >= kMaxSendsPerWindow) {
+			_sendTimer.callOnce(_sendWindowStart + kSendWindow - now);
+			return;
+		}
+		_pending.pop_front();
+		++_sentInWindow;
+		notification->show();
 	}
-	const auto j = i->second.emplace(
-		msgId,
-		std::move(notification)).first;
-	j->second->show();
 }
 
 void Manager::Private::clearAll() {
@@ -862,6 +958,7 @@ void Manager::Private::clearFromItem(not_null<HistoryItem*> item) {
 		_notifications.erase(i);
 	}
 	taken->close();
+	pendingRemoved();
 }
 
 void Manager::Private::clearFromTopic(not_null<Data::ForumTopic*> topic) {
@@ -878,6 +975,7 @@ void Manager::Private::clearFromTopic(not_null<Data::ForumTopic*> topic) {
 			notification->close();
 		}
 	}
+	pendingRemoved();
 }
 
 void Manager::Private::clearFromHistory(not_null<History*> history) {
@@ -897,6 +995,7 @@ void Manager::Private::clearFromHistory(not_null<History*> history) {
 			notification->close();
 		}
 	}
+	pendingRemoved();
 }
 
 void Manager::Private::clearFromSession(not_null<Main::Session*> session) {
@@ -912,6 +1011,7 @@ void Manager::Private::clearFromSession(not_null<Main::Session*> session) {
 			notification->close();
 		}
 	}
+	pendingRemoved();
 }
 
 void Manager::Private::clearNotification(NotificationId id) {
@@ -921,6 +1021,7 @@ void Manager::Private::clearNotification(NotificationId id) {
 			_notifications.erase(i);
 		}
 	}
+	pendingRemoved();
 }
 
 void Manager::Private::invokeIfNotInhibited(Fn<void()> callback) {
@@ -27,6 +27,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/wrap/slide_wrap.h"
 #include "ui/widgets/fields/input_field.h"
 #include "ui/widgets/checkbox.h"
+#include "ui/widgets/labels.h"
 #include "ui/widgets/color_editor.h"
 #include "ui/widgets/buttons.h"
 #include "ui/chat/attach/attach_extensions.h"
@@ -66,6 +67,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/platform/base_platform_info.h"
 #include "base/call_delayed.h"
 #include "support/support_common.h"
+#include "support/support_helper.h"
+#include "support/support_preload.h"
 #include "support/support_templates.h"
 #include "main/main_session.h"
 #include "main/main_session_settings.h"
@@ -1778,6 +1781,25 @@ void SetupSupport(
 
 	Ui::AddSkip(inner, st::settingsCheckboxesSkip);
 
+	Ui::AddSubsectionTitle(inner, rpl::single(u"Chats preloading"_q));
+
+	using Stats = Support::Preloader::Stats;
+	inner->add(
+		object_ptr<Ui::FlatLabel>(
+			inner,
+			controller->session().supportHelper().preloader().statsValue(
+			) | rpl::map([](Stats stats) {
+				const auto total = stats.hits + stats.misses;
+				return u"%1 of %2 opened chats were preloaded (%3%)"_q
+					.arg(stats.hits)
+					.arg(total)
+					.arg(total ? (stats.hits * 100 / total) : 0);
+			}),
+			st::settingsUpdateState),
+		st::settingsSendTypePadding);
+
+	Ui::AddSkip(inner, st::settingsCheckboxesSkip);
+
 	Ui::AddSkip(inner);
 }
 
@@ -33,6 +33,7 @@ namespace Statistic {
 namespace {
 
 constexpr auto kHeightLimitsUpdateTimeout = crl::time(320);
+constexpr auto kPaintStatsPeriod = crl::time(1000);
 
 inline float64 InterpolationRatio(float64 from, float64 to, float64 result) {
 	return (result - from) / (to - from);
@@ -64,6 +65,44 @@ void FillLineColorsByKey(Data::StatisticalChart &chartData) {
 	}
 }
 
+class PaintStats final {
+public:
+	explicit PaintStats(QString name);
+
+	void add(crl::time started, crl::time finished);
+
+private:
+	const QString _name;
+	crl::time _periodStarted = 0;
+	crl::time _total = 0;
+	crl::time _max = 0;
+	int _frames = 0;
+
+};
+
+PaintStats::PaintStats(QString name) : _name(std::move(name)) {
+}
+
+void PaintStats::add(crl::time started, crl::time finished) {
+	const auto duration = finished - started;
+	_total += duration;
+	_max = std::max(_max, duration);
+	++_frames;
+	if (!_periodStarted) {
+		_periodStarted = started;
+	} else if (finished - _periodStarted >= kPaintStatsPeriod) {
+		DEBUG_LOG(("Statistics Chart: "
+			"%1 painted %2 frames, %3 ms average, %4 ms max."
+			).arg(_name
+			).arg(_frames
+			).arg(_total / float64(_frames), 0, 'f', 2
+			).arg(_max));
+		_periodStarted = finished;
+		_total = _max = 0;
+		_frames = 0;
+	}
+}
+
 [[nodiscard]] QString HeaderSubTitle(
 		const Data::StatisticalChart &chartData,
 		int xIndexMin,
@@ -927,6 +966,8 @@ QRect ChartWidget::chartAreaRect() const {
 }
 
 void ChartWidget::setupChartArea() {
+	const auto paintStats = _chartArea->lifetime().make_state<PaintStats>(
+		u"Chart"_q);
 	_chartArea->paintRequest(
 	) | rpl::start_with_next([=](const QRect &r) {
 		auto p = QPainter(_chartArea.get());
@@ -963,7 +1004,9 @@ void ChartWidget::setupChartArea() {
 
 		{
 			PainterHighQualityEnabler hp(p);
+			const auto started = crl::now();
 			_chartView->paint(p, context);
+			paintStats->add(started, crl::now());
 		}
 
 		if (!_areRulersAbove) {
@@ -1091,6 +1134,8 @@ void ChartWidget::updateHeader() {
 }
 
 void ChartWidget::setupFooter() {
+	const auto paintStats = _footer->lifetime().make_state<PaintStats>(
+		u"Footer"_q);
 	_footer->setPaintChartCallback([=, fullXLimits = Limits{ 0., 1. }](
 			QPainter &p,
 			const QRect &r) {
@@ -1098,6 +1143,7 @@ void ChartWidget::setupFooter() {
 			p.fillRect(r, st::boxBg);
 
 			auto hp = PainterHighQualityEnabler(p);
+			const auto started = crl::now();
 			_chartView->paint(
 				p,
 				PaintContext{
@@ -1108,6 +1154,7 @@ void ChartWidget::setupFooter() {
 					r,
 					true,
 				});
+			paintStats->add(started, crl::now());
 		}
 	});
 
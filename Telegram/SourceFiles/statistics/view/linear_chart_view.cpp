@@ -35,6 +35,37 @@ void PaintChartLine(
 
 	const auto ratio = ratios.ratio(line.id);
 
+	// Points sharing a pixel column can't be told apart, so only the first,
+	// the last, the topmost and the bottommost of them are plotted.
+	// This keeps the polyline shape for years of daily or hourly points.
+	struct Point final {
+		QPointF position;
+		int index = 0;
+	};
+	struct Column final {
+		Point first;
+		Point last;
+		Point top;
+		Point bottom;
+	};
+	const auto columnsInPixel = float64(style::DevicePixelRatio());
+	auto column = std::optional<Column>();
+	auto columnIndex = 0;
+	auto pushedIndex = -1;
+	const auto push = [&](const Point &point) {
+		if (point.index != pushedIndex) {
+			chartPoints << point.position;
+			pushedIndex = point.index;
+		}
+	};
+	const auto flush = [&] {
+		const auto topFirst = (column->top.index < column->bottom.index);
+		push(column->first);
+		push(topFirst ? column->top : column->bottom);
+		push(topFirst ? column->bottom : column->top);
+		push(column->last);
+	};
+
 	for (auto i = localStart; i <= localEnd; i++) {
 		if (line.y[i] < 0) {
 			continue;
@@ -45,7 +76,26 @@ void PaintChartLine(
 		const auto yPercentage = (line.y[i] * ratio - c.heightLimits.min)
 			/ float64(c.heightLimits.max - c.heightLimits.min);
 		const auto yPoint = (1. - yPercentage) * c.rect.height();
-		chartPoints << QPointF(xPoint, yPoint);
+		const auto point = Point{ QPointF(xPoint, yPoint), i };
+		const auto index = int(std::floor(xPoint * columnsInPixel));
+		if (!column || columnIndex != index) {
+			if (column) {
+				flush();
+			}
+			column = Column{ point, point, point, point };
+			columnIndex = index;
+			continue;
+		}
+		column->last = point;
+		if (yPoint < column->top.position.y()) {
+			column->top = point;
+		}
+		if (yPoint > column->bottom.position.y()) {
+			column->bottom = point;
+		}
+	}
+	if (column) {
+		flush();
 	}
 	p.setPen(QPen(
 		line.color,
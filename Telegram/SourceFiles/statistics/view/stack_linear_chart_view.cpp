@@ -307,7 +307,71 @@ void StackLinearChartView::paintChartOrZoomAnimation(
 		ovalPath = ovalPath.intersected(rectPath);
 	}
 
+	const auto columnsInPixel = float64(style::DevicePixelRatio());
+	const auto columnOf = [&](int i) {
+		return int(std::floor(columnsInPixel
+			* c.rect.width()
+			* ((c.chartData.xPercentage[i] - xPercentageLimits.min)
+				/ (xPercentageLimits.max - xPercentageLimits.min))));
+	};
+
+	// Points of the same pixel column can't be told apart, so only the
+	// first, the last and the ones with the lowest and the highest
+	// stacked value of each line in the column are plotted.
+	const auto keepFrom = int(localStart);
+	auto keep = std::vector<char>();
+	if (!hasTransitionAnimation) {
+		const auto till = int(localEnd) + 1;
+		const auto linesCount = int(c.chartData.lines.size());
+		auto minValue = std::vector<float64>(linesCount);
+		auto maxValue = std::vector<float64>(linesCount);
+		auto minIndex = std::vector<int>(linesCount);
+		auto maxIndex = std::vector<int>(linesCount);
+		auto columnStart = keepFrom;
+		auto column = columnOf(keepFrom);
+		const auto flushColumn = [&](int last) {
+			keep[columnStart - keepFrom] = keep[last - keepFrom] = 1;
+			for (auto k = 0; k != linesCount; ++k) {
+				keep[minIndex[k] - keepFrom] = 1;
+				keep[maxIndex[k] - keepFrom] = 1;
+			}
+		};
+		keep.resize(std::max(till - keepFrom, 0), 0);
+		for (auto i = keepFrom; i < till; ++i) {
+			if (const auto now = columnOf(i); now != column) {
+				flushColumn(i - 1);
+				column = now;
+				columnStart = i;
+			}
+			auto sum = 0.;
+			for (const auto &line : c.chartData.lines) {
+				sum += line.y[i] * linesFilter->alpha(line.id);
+			}
+			auto stacked = 0.;
+			for (auto k = 0; k != linesCount; ++k) {
+				const auto &line = c.chartData.lines[k];
+				if (sum) {
+					stacked += line.y[i] * linesFilter->alpha(line.id) / sum;
+				}
+				if (i == columnStart || stacked < minValue[k]) {
+					minValue[k] = stacked;
+					minIndex[k] = i;
+				}
+				if (i == columnStart || stacked > maxValue[k]) {
+					maxValue[k] = stacked;
+					maxIndex[k] = i;
+				}
+			}
+		}
+		if (!keep.empty()) {
+			flushColumn(till - 1);
+		}
+	}
+
 	for (auto i = localStart; i <= localEnd; i++) {
+		if (!keep.empty() && !keep[int(i) - keepFrom]) {
+			continue;
+		}
 		auto stackOffset = 0.;
 		auto sum = 0.;
 		auto lastEnabled = int(0);
@@ -21,6 +21,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/file_location.h"
 #include "core/mime_type.h"
 #include "main/main_session.h"
+#include "base/random.h"
 #include "apiwrap.h"
 
 namespace Storage {
@@ -63,6 +64,11 @@ constexpr auto kSlowRequestThreshold = 8 * crl::time(1000);
 // (it-s size + queued before size) >= 512kb.
 constexpr auto kAcceptAsFastIfTotalAtLeast = 512 * 1024;
 
+// Streamed files are written slowly, so we upload their parts one by
+// one using the smallest part size, it is allowed for files up to 128mb.
+constexpr auto kStreamedPartSize = kDocumentUploadPartSize0;
+constexpr auto kStreamedUploadsLimit = 4;
+
 [[nodiscard]] const char *ThumbnailFormat(const QString &mime) {
 	return Core::IsMimeSticker(mime) ? "WEBP" : "JPG";
 }
@@ -88,6 +94,7 @@ struct Uploader::Entry {
 	HashMd5 md5Hash;
 
 	std::unique_ptr<QFile> docFile;
+	uint64 docFileId = 0;
 	int64 docSize = 0;
 	int64 docSentSize = 0;
 	int docPartSize = 0;
@@ -97,6 +104,14 @@ struct Uploader::Entry {
 
 };
 
+struct Uploader::Streamed {
+	uint64 id = 0;
+	QByteArray bytes;
+	mtpRequestId requestId = 0;
+	int partsUploaded = 0;
+	bool failed = false;
+};
+
 struct Uploader::Request {
 	FullMsgId itemId;
 	crl::time sent = 0;
@@ -125,6 +140,7 @@ Uploader::Entry::Entry(
 	if (file->type == SendMediaType::File
 		|| file->type == SendMediaType::ThemeFile
 		|| file->type == SendMediaType::Audio) {
+		docFileId = file->id;
 		setDocSize(file->filesize);
 	}
 }
@@ -331,11 +347,112 @@ void Uploader::upload(
 		}
 	}
 	_queue.push_back({ itemId, file });
+	if (adoptStreamed(&_queue.back())) {
+		// All the parts could be uploaded already.
+		crl::on_main(this, [=] {
+			maybeFinishFront();
+		});
+	}
 	if (!_nextTimer.isActive()) {
 		maybeSend();
 	}
 }
 
+uint64 Uploader::startStreamed() {
+	if (_streamed.size() >= kStreamedUploadsLimit) {
+		cancelStreamed(_streamed.front().id);
+	}
+	const auto id = base::RandomValue<uint64>();
+	_streamed.push_back({ .id = id });
+	return id;
+}
+
+void Uploader::appendStreamed(uint64 id, const QByteArray &bytes) {
+	if (const auto streamed = findStreamed(id)) {
+		streamed->bytes.append(bytes);
+		sendStreamedPart(streamed);
+	}
+}
+
+void Uploader::cancelStreamed(uint64 id) {
+	const auto i = ranges::find(_streamed, id, &Streamed::id);
+	if (i != end(_streamed)) {
+		if (i->requestId) {
+			_api->request(i->requestId).cancel();
+		}
+		_streamed.erase(i);
+	}
+}
+
+Uploader::Streamed *Uploader::findStreamed(uint64 id) {
+	const auto i = ranges::find(_streamed, id, &Streamed::id);
+	return (i != end(_streamed)) ? &*i : nullptr;
+}
+
+void Uploader::sendStreamedPart(not_null<Streamed*> streamed) {
+	const auto offset = streamed->partsUploaded * kStreamedPartSize;
+	if (streamed->requestId
+		|| streamed->failed
+		|| streamed->bytes.size() < offset + kStreamedPartSize) {
+		return;
+	}
+	const auto id = streamed->id;
+	streamed->requestId = _api->request(MTPupload_SaveFilePart(
+		MTP_long(id),
+		MTP_int(streamed->partsUploaded),
+		MTP_bytes(streamed->bytes.mid(offset, kStreamedPartSize))
+	)).done([=](const MTPBool &result) {
+		if (const auto streamed = findStreamed(id)) {
+			streamed->requestId = 0;
+			if (mtpIsFalse(result)) {
+				streamed->failed = true;
+			} else {
+				++streamed->partsUploaded;
+				sendStreamedPart(streamed);
+			}
+		}
+	}).fail([=] {
+		// Parts uploaded before are still good for the upload() call.
+		if (const auto streamed = findStreamed(id)) {
+			streamed->requestId = 0;
+			streamed->failed = true;
+		}
+	}).send();
+}
+
+bool Uploader::adoptStreamed(not_null<Entry*> entry) {
+	const auto &content = entry->file->content;
+	if (!entry->docFileId
+		|| content.isEmpty()
+		|| entry->docSize > kUseBigFilesFrom) {
+		return false;
+	}
+
+	// Comparing the bytes makes sure we never send a broken file.
+	const auto i = ranges::find_if(_streamed, [&](const Streamed &streamed) {
+		const auto size = streamed.partsUploaded * kStreamedPartSize;
+		return (size > 0)
+			&& (size <= content.size())
+			&& !memcmp(content.constData(), streamed.bytes.constData(), size);
+	});
+	if (i == end(_streamed)) {
+		return false;
+	} else if (!entry->setPartSize(kStreamedPartSize)) {
+		entry->setDocSize(entry->docSize);
+		return false;
+	}
+	const auto uploaded = i->partsUploaded * kStreamedPartSize;
+	entry->docFileId = i->id;
+	entry->docPartsSent = i->partsUploaded;
+	entry->docSentSize = uploaded;
+	entry->md5Hash.feed(content.constData(), uploaded);
+	DEBUG_LOG(("Uploader: Continuing streamed upload from %1 of %2 bytes."
+		).arg(uploaded
+		).arg(content.size()));
+	cancelStreamed(i->id);
+	return true;
+}
+
 void Uploader::failed(FullMsgId itemId) {
 	const auto i = ranges::find(_queue, itemId, &Entry::itemId);
 	if (i != end(_queue)) {
@@ -502,13 +619,13 @@ auto Uploader::sendPendingPart(not_null<Entry*> entry, uchar dcIndex)
 	request.dcIndex = dcIndex;
 	if (request.bigPart) {
 		sendPreparedRequest(MTPupload_SaveBigFilePart(
-			MTP_long(entry->file->id),
+			MTP_long(entry->docFileId),
 			MTP_int(part),
 			MTP_int(entry->docPartsCount),
 			MTP_bytes(bytes)
 		), std::move(request));
 	} else {
-		const auto id = request.docPart ? entry->file->id : entry->partsOfId;
+		const auto id = request.docPart ? entry->docFileId : entry->partsOfId;
 		sendPreparedRequest(MTPupload_SaveFilePart(
 			MTP_long(id),
 			MTP_int(part),
@@ -549,14 +666,14 @@ auto Uploader::sendDocPart(not_null<Entry*> entry, uchar dcIndex)
 	};
 	if (entry->docSize > kUseBigFilesFrom) {
 		send(MTPupload_SaveBigFilePart(
-			MTP_long(entry->file->id),
+			MTP_long(entry->docFileId),
 			MTP_int(part),
 			MTP_int(entry->docPartsCount),
 			MTP_bytes(partBytes)
 		), true);
 	} else {
 		send(MTPupload_SaveFilePart(
-			MTP_long(entry->file->id),
+			MTP_long(entry->docFileId),
 			MTP_int(part),
 			MTP_bytes(partBytes)
 		), false);
@@ -681,6 +798,9 @@ void Uploader::cancelAllRequests() {
 
 void Uploader::clear() {
 	_queue.clear();
+	while (!_streamed.empty()) {
+		cancelStreamed(_streamed.front().id);
+	}
 	cancelAllRequests();
 	stopSessions();
 	_stopSessionsTimer.cancel();
@@ -862,11 +982,11 @@ void Uploader::finishFront() {
 
 		const auto file = (entry.docSize > kUseBigFilesFrom)
 			? MTP_inputFileBig(
-				MTP_long(entry.file->id),
+				MTP_long(entry.docFileId),
 				MTP_int(entry.docPartsCount),
 				MTP_string(entry.file->filename))
 			: MTP_inputFile(
-				MTP_long(entry.file->id),
+				MTP_long(entry.docFileId),
 				MTP_int(entry.docPartsCount),
 				MTP_string(entry.file->filename),
 				MTP_bytes(docMd5));
@@ -63,6 +63,13 @@ public:
 	void cancel(FullMsgId itemId);
 	void cancelAll();
 
+	// Parts of a file still being written, like a voice message being
+	// recorded, are uploaded right away. When later the same bytes are
+	// passed to upload() it continues from the already uploaded parts.
+	[[nodiscard]] uint64 startStreamed();
+	void appendStreamed(uint64 id, const QByteArray &bytes);
+	void cancelStreamed(uint64 id);
+
 	[[nodiscard]] rpl::producer<UploadedMedia> photoReady() const {
 		return _photoReady.events();
 	}
@@ -102,6 +109,7 @@ public:
 private:
 	struct Entry;
 	struct Request;
+	struct Streamed;
 
 	enum class SendResult : uchar {
 		Success,
@@ -124,6 +132,10 @@ private:
 	[[nodiscard]] QByteArray readDocPart(not_null<Entry*> entry);
 	void removeDcIndex();
 
+	[[nodiscard]] Streamed *findStreamed(uint64 id);
+	void sendStreamedPart(not_null<Streamed*> streamed);
+	[[nodiscard]] bool adoptStreamed(not_null<Entry*> entry);
+
 	template <typename Prepared>
 	void sendPreparedRequest(Prepared &&prepared, Request &&request);
 
@@ -153,6 +165,7 @@ private:
 	const not_null<ApiWrap*> _api;
 
 	std::vector<Entry> _queue;
+	std::vector<Streamed> _streamed;
 
 	base::flat_map<mtpRequestId, Request> _requests;
 	std::vector<int> _sentPerDcIndex;
@@ -40,6 +40,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 
 #include <QtCore/QBuffer>
+#include <QtCore/QSemaphore>
 #include <QtGui/QImageWriter>
 
 namespace {
@@ -49,6 +50,9 @@ constexpr auto kThumbnailSize = 320;
 constexpr auto kPhotoUploadPartSize = 32 * 1024;
 constexpr auto kRecompressAfterBpp = 4;
 
+// Each task may hold a full decoded image, so keep the batch small.
+constexpr auto kMaxParallelTasks = 4;
+
 using Ui::ValidateThumbDimensions;
 
 base::options::toggle SendLargePhotos({
@@ -206,6 +210,13 @@ struct PreparedFileThumbnail {
 	return result;
 }
 
+struct StageTimings {
+	crl::time read = 0;
+	crl::time resize = 0;
+	crl::time encode = 0;
+	crl::time hash = 0;
+};
+
 [[nodiscard]] int PhotoSideLimit(bool large) {
 	return large ? 2560 : 1280;
 }
@@ -283,9 +294,9 @@ void TaskQueue::cancelTask(TaskId id) {
 	{
 		QMutexLocker lock(&_tasksToProcessMutex);
 		removeFrom(_tasksToProcess);
-		if (_taskInProcessId == id) {
-			_taskInProcessId = TaskId();
-		}
+		_tasksInProcess.erase(
+			ranges::remove(_tasksInProcess, id),
+			end(_tasksInProcess));
 	}
 	QMutexLocker lock(&_tasksToFinishMutex);
 	removeFrom(_tasksToFinish);
@@ -305,7 +316,7 @@ void TaskQueue::onTaskProcessed() {
 
 	if (_stopTimer) {
 		QMutexLocker lock(&_tasksToProcessMutex);
-		if (_tasksToProcess.empty() && !_taskInProcessId) {
+		if (_tasksToProcess.empty() && _tasksInProcess.empty()) {
 			_stopTimer->start();
 		}
 	}
@@ -322,7 +333,7 @@ void TaskQueue::stop() {
 	}
 	_tasksToProcess.clear();
 	_tasksToFinish.clear();
-	_taskInProcessId = TaskId();
+	_tasksInProcess.clear();
 }
 
 TaskQueue::~TaskQueue() {
@@ -334,31 +345,53 @@ void TaskQueueWorker::onTaskAdded() {
 	if (_inTaskAdded) return;
 	_inTaskAdded = true;
 
+	const auto limit = std::clamp(
+		QThread::idealThreadCount(),
+		1,
+		kMaxParallelTasks);
 	bool someTasksLeft = false;
 	do {
-		auto task = std::unique_ptr<Task>();
+		auto tasks = std::vector<std::unique_ptr<Task>>();
 		{
 			QMutexLocker lock(&_queue->_tasksToProcessMutex);
-			if (!_queue->_tasksToProcess.empty()) {
-				task = std::move(_queue->_tasksToProcess.front());
-				_queue->_tasksToProcess.pop_front();
-				_queue->_taskInProcessId = task->id();
+			auto &queue = _queue->_tasksToProcess;
+			while (!queue.empty() && int(tasks.size()) < limit) {
+				tasks.push_back(std::move(queue.front()));
+				queue.pop_front();
+				_queue->_tasksInProcess.push_back(tasks.back()->id());
 			}
 		}
 
-		if (task) {
-			task->process();
+		if (!tasks.empty()) {
+			// The first task is processed here, the others in parallel.
+			// The results are finished in the order of the queue anyway,
+			// so that the album items are sent in the right order.
+			QSemaphore semaphore;
+			for (auto i = 1; i != int(tasks.size()); ++i) {
+				crl::async([&semaphore, task = tasks[i].get()] {
+					task->process();
+					semaphore.release();
+				});
+			}
+			tasks.front()->process();
+			semaphore.acquire(int(tasks.size()) - 1);
+
 			bool emitTaskProcessed = false;
 			{
 				QMutexLocker lockToProcess(&_queue->_tasksToProcessMutex);
-				if (_queue->_taskInProcessId == task->id()) {
-					_queue->_taskInProcessId = TaskId();
-					someTasksLeft = !_queue->_tasksToProcess.empty();
-
-					QMutexLocker lockToFinish(&_queue->_tasksToFinishMutex);
-					emitTaskProcessed = _queue->_tasksToFinish.empty();
-					_queue->_tasksToFinish.push_back(std::move(task));
+				QMutexLocker lockToFinish(&_queue->_tasksToFinishMutex);
+				auto &processing = _queue->_tasksInProcess;
+				auto &finishing = _queue->_tasksToFinish;
+				const auto wasEmpty = finishing.empty();
+				for (auto &task : tasks) {
+					const auto i = ranges::find(processing, task->id());
+					if (i != end(processing)) {
+						processing.erase(i);
+						finishing.push_back(std::move(task));
+					}
 				}
+				someTasksLeft = !_queue->_tasksToProcess.empty();
+				emitTaskProcessed = wasEmpty && !finishing.empty();
 			}
 			if (emitTaskProcessed) {
 				taskProcessed();
@@ -679,6 +712,23 @@ bool FileLoadTask::FillImageInformation(
 }
 
 void FileLoadTask::process(Args &&args) {
+	auto timings = StageTimings();
+	auto stageStarted = crl::now();
+	const auto stageFinished = [&](crl::time &stage) {
+		const auto now = crl::now();
+		stage += now - stageStarted;
+		stageStarted = now;
+	};
+	const auto logTimings = gsl::finally([&] {
+		DEBUG_LOG(("File Prepare: %1 read %2 ms, resize %3 ms, "
+			"encode %4 ms, hash %5 ms."
+			).arg(_filepath.isEmpty() ? u"(memory)"_q : _filepath
+			).arg(timings.read
+			).arg(timings.resize
+			).arg(timings.encode
+			).arg(timings.hash));
+	});
+
 	_result = MakePreparedFile({
 		.taskId = id(),
 		.id = _id,
@@ -798,6 +848,7 @@ void FileLoadTask::process(Args &&args) {
 		}
 	}
 	_result->filesize = qMin(filesize, qint64(UINT_MAX));
+	stageFinished(timings.read);
 
 	if (!filesize || filesize > kFileSizePremiumLimit) {
 		return;
@@ -820,6 +871,7 @@ void FileLoadTask::process(Args &&args) {
 			_information = readMediaInformation(filemime);
 			filemime = _information->filemime;
 		}
+		stageFinished(timings.read);
 		if (auto song = std::get_if<Ui::PreparedFileInformation::Song>(
 				&_information->media)) {
 			isSong = true;
@@ -867,6 +919,7 @@ void FileLoadTask::process(Args &&args) {
 			}
 		}
 	}
+	stageFinished(timings.encode);
 
 	if (!fullimage.isNull() && fullimage.width() > 0 && !isSong && !isVideo && !isVoice) {
 		auto w = fullimage.width(), h = fullimage.height();
@@ -898,15 +951,20 @@ void FileLoadTask::process(Args &&args) {
 				if (Core::IsMimeSticker(filemime)) {
 					fullimage = Images::Opaque(std::move(fullimage));
 				}
-				auto medium = (w > 320 || h > 320) ? fullimage.scaled(320, 320, Qt::KeepAspectRatio, Qt::SmoothTransformation) : fullimage;
-
 				const auto limit = PhotoSideLimitAtomic();
 				const auto downscaled = (w > limit || h > limit);
 				auto full = downscaled ? fullimage.scaled(limit, limit, Qt::KeepAspectRatio, Qt::SmoothTransformation) : fullimage;
 				if (downscaled) {
 					fullimagebytes = fullimageformat = QByteArray();
 				}
+
+				// Smaller sizes are scaled from the already downscaled one.
+				auto medium = (w > 320 || h > 320) ? full.scaled(320, 320, Qt::KeepAspectRatio, Qt::SmoothTransformation) : full;
+				fullimage = medium;
+				stageFinished(timings.resize);
+
 				filedata = ComputePhotoJpegBytes(full, fullimagebytes, fullimageformat);
+				stageFinished(timings.encode);
 
 				photoThumbs.emplace('m', PreparedPhotoThumb{ .image = medium });
 				photoSizes.push_back(MTP_photoSize(MTP_string("m"), MTP_int(medium.width()), MTP_int(medium.height()), MTP_int(0)));
@@ -934,11 +992,13 @@ void FileLoadTask::process(Args &&args) {
 			thumbnail = PrepareFileThumbnail(std::move(fullimage));
 		}
 	}
+	stageFinished(timings.resize);
 	thumbnail = FinalizeFileThumbnail(
 		std::move(thumbnail),
 		filemime,
 		filesize,
 		isSticker);
+	stageFinished(timings.encode);
 
 	if (_type == SendMediaType::Photo && photoThumbs.empty()) {
 		_type = SendMediaType::File;
@@ -1000,6 +1060,7 @@ void FileLoadTask::process(Args &&args) {
 	_result->thumbId = thumbnail.id;
 	_result->thumbname = thumbnail.name;
 	_result->setThumbData(thumbnail.bytes);
+	stageFinished(timings.hash);
 	_result->thumb = std::move(thumbnail.image);
 
 	_result->goodThumbnail = std::move(goodThumbnail);
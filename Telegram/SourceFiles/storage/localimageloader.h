@@ -78,7 +78,7 @@ private:
 
 	std::deque<std::unique_ptr<Task>> _tasksToProcess;
 	std::deque<std::unique_ptr<Task>> _tasksToFinish;
-	TaskId _taskInProcessId = TaskId();
+	std::vector<TaskId> _tasksInProcess;
 	QMutex _tasksToProcessMutex, _tasksToFinishMutex;
 	QThread *_thread = nullptr;
 	TaskQueueWorker *_worker = nullptr;
@@ -58,18 +58,39 @@ QSize PrepareShownDimensions(const QImage &preview, int sideLimit) {
 void PrepareDetailsInParallel(PreparedList &result, int previewWidth) {
 	Expects(result.files.size() <= Ui::MaxAlbumItems());
 
-	if (result.files.empty()) {
+	const auto count = int(result.files.size());
+	if (!count) {
 		return;
 	}
 	const auto sideLimit = PhotoSideLimit(); // Get on main thread.
+
+	// Largest files go first, so that the slowest decode doesn't end up
+	// being started last while all the other workers are already idle.
+	auto order = ranges::views::ints(0, count) | ranges::to_vector;
+	ranges::stable_sort(order, ranges::greater(), [&](int index) {
+		return result.files[index].size;
+	});
+
+	// A bounded set of workers takes files one by one, the calling
+	// thread works as well instead of just waiting for the results.
+	auto next = std::atomic<int>(0);
+	const auto work = [&] {
+		for (auto i = next++; i < count; i = next++) {
+			PrepareDetails(result.files[order[i]], previewWidth, sideLimit);
+		}
+	};
+	const auto helpers = std::min(
+		count,
+		std::max(QThread::idealThreadCount(), 1)) - 1;
 	QSemaphore semaphore;
-	for (auto &file : result.files) {
-		crl::async([=, &semaphore, &file] {
-			PrepareDetails(file, previewWidth, sideLimit);
+	for (auto i = 0; i != helpers; ++i) {
+		crl::async([&] {
+			work();
 			semaphore.release();
 		});
 	}
-	semaphore.acquire(result.files.size());
+	work();
+	semaphore.acquire(helpers);
 }
 
 } // namespace
@@ -215,7 +236,7 @@ PreparedList PrepareMediaList(
 			result.files.back().size = filesize;
 		} else {
 			result.filesToProcess.emplace_back(file);
-			result.files.back().size = filesize;
+			result.filesToProcess.back().size = filesize;
 		}
 	}
 	PrepareDetailsInParallel(result, previewWidth);
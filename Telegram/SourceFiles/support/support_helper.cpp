@@ -262,6 +262,7 @@ Helper::Helper(not_null<Main::Session*> session)
 : _session(session)
 , _api(&_session->mtp())
 , _templates(_session)
+, _preloader(_session)
 , _reoccupyTimer([=] { reoccupy(); })
 , _checkOccupiedTimer([=] { checkOccupiedChats(); }) {
 	_api.request(MTPhelp_GetSupportName(
@@ -540,6 +541,10 @@ Templates &Helper::templates() {
 	return _templates;
 }
 
+Preloader &Helper::preloader() {
+	return _preloader;
+}
+
 QString ChatOccupiedString(not_null<History*> history) {
 	const auto hand = QString::fromUtf8("\xe2\x9c\x8b\xef\xb8\x8f");
 	const auto name = ParseOccupationName(history);
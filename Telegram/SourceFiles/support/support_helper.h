@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "base/timer.h"
 #include "support/support_templates.h"
+#include "support/support_preload.h"
 #include "mtproto/sender.h"
 
 class History;
@@ -64,6 +65,7 @@ public:
 		not_null<UserData*> user);
 
 	Templates &templates();
+	Preloader &preloader();
 
 private:
 	struct SavingInfo {
@@ -93,6 +95,7 @@ private:
 	not_null<Main::Session*> _session;
 	MTP::Sender _api;
 	Templates _templates;
+	Preloader _preloader;
 	QString _supportName;
 	QString _supportNameNormalized;
 
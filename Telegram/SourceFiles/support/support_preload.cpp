@@ -8,10 +8,17 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "support/support_preload.h"
 
 #include "history/history.h"
+#include "history/history_item.h"
+#include "history/view/history_view_element.h"
 #include "data/data_peer.h"
+#include "data/data_photo.h"
+#include "data/data_document.h"
+#include "data/data_media_types.h"
 #include "data/data_session.h"
 #include "data/data_histories.h"
+#include "data/data_file_origin.h"
 #include "main/main_session.h"
+#include "window/window_session_controller.h"
 #include "apiwrap.h"
 
 namespace Support {
@@ -19,9 +26,19 @@ namespace {
 
 constexpr auto kPreloadMessagesCount = 50;
 
+// Not to take the whole connection from the chat the operator is in.
+constexpr auto kPreloadRequestsLimit = 2;
+constexpr auto kPreloadMediaPerChat = 16;
+constexpr auto kKeepWarmCount = 8;
+constexpr auto kRetryFailedDelay = 10 * crl::time(1000);
+
 } // namespace
 
-int SendPreloadRequest(not_null<History*> history, Fn<void()> retry) {
+int SendPreloadRequest(
+		not_null<History*> history,
+		Fn<void()> retry,
+		Fn<void()> done,
+		Fn<void()> fail) {
 	auto offsetId = MsgId();
 	auto offset = 0;
 	auto loadCount = kPreloadMessagesCount;
@@ -68,10 +85,183 @@ int SendPreloadRequest(not_null<History*> history, Fn<void()> retry) {
 				history->addOlderSlice(data.vmessages().v);
 			});
 			finish();
+			if (done) {
+				done();
+			}
 		}).fail([=](const MTP::Error &error) {
 			finish();
+			if (fail) {
+				fail();
+			}
 		}).send();
 	});
 }
 
+Preloader::Preloader(not_null<Main::Session*> session)
+: _session(session)
+, _retryTimer([=] { sendNext(); }) {
+}
+
+Preloader::~Preloader() {
+	auto &histories = _session->data().histories();
+	for (const auto &request : base::take(_requests)) {
+		histories.cancelRequest(request.requestId);
+	}
+}
+
+void Preloader::setQueue(std::vector<not_null<History*>> queue) {
+	for (auto i = begin(_requests); i != end(_requests);) {
+		if (ranges::contains(queue, i->history)) {
+			++i;
+		} else {
+			_session->data().histories().cancelRequest(i->requestId);
+			i = _requests.erase(i);
+		}
+	}
+	for (auto i = begin(_failed); i != end(_failed);) {
+		if (ranges::contains(queue, i->first)) {
+			++i;
+		} else {
+			i = _failed.erase(i);
+		}
+	}
+	_queue = std::move(queue);
+	sendNext();
+}
+
+void Preloader::sendNext() {
+	for (const auto history : _queue) {
+		if (int(_requests.size()) >= kPreloadRequestsLimit) {
+			return;
+		} else if (history == _shown
+			|| ranges::contains(_warm, history)
+			|| (ranges::find(_requests, history, &Request::history)
+				!= end(_requests))
+			|| failedRecently(history)
+			|| history->isReadyFor(ShowAtUnreadMsgId)) {
+			continue;
+		}
+		const auto weak = base::make_weak(this);
+		const auto requestId = SendPreloadRequest(history, [=] {
+			crl::on_main(weak, [=] {
+				cancel(history);
+				sendNext();
+			});
+		}, crl::guard(weak, [=] {
+			loaded(history);
+		}), crl::guard(weak, [=] {
+			failed(history);
+		}));
+		_requests.push_back({ history, requestId });
+	}
+}
+
+void Preloader::cancel(not_null<History*> history) {
+	const auto i = ranges::find(_requests, history, &Request::history);
+	if (i != end(_requests)) {
+		_session->data().histories().cancelRequest(i->requestId);
+		_requests.erase(i);
+	}
+}
+
+void Preloader::loaded(not_null<History*> history) {
+	const auto i = ranges::find(_requests, history, &Request::history);
+	if (i != end(_requests)) {
+		_requests.erase(i);
+	}
+	markWarm(history);
+	preloadMedia(history);
+	crl::on_main(this, [=] { sendNext(); });
+}
+
+void Preloader::failed(not_null<History*> history) {
+	const auto i = ranges::find(_requests, history, &Request::history);
+	if (i != end(_requests)) {
+		_requests.erase(i);
+	}
+	_failed[history] = crl::now();
+	_retryTimer.callOnce(kRetryFailedDelay);
+	crl::on_main(this, [=] { sendNext(); });
+}
+
+bool Preloader::failedRecently(not_null<History*> history) const {
+	const auto i = _failed.find(history);
+	return (i != end(_failed))
+		&& (crl::now() - i->second < kRetryFailedDelay);
+}
+
+void Preloader::preloadMedia(not_null<History*> history) {
+	auto userpics = base::flat_set<not_null<PeerData*>>();
+	auto left = kPreloadMediaPerChat;
+	for (const auto &block : ranges::views::reverse(history->blocks)) {
+		for (const auto &view : ranges::views::reverse(block->messages)) {
+			const auto item = view->data();
+			const auto from = item->from();
+			if (userpics.emplace(from).second) {
+				from->loadUserpic();
+			}
+			if (left <= 0) {
+				continue;
+			} else if (const auto media = item->media()) {
+				if (const auto photo = media->photo()) {
+					photo->load(Data::PhotoSize::Thumbnail, item->fullId());
+					--left;
+				} else if (const auto document = media->document()) {
+					document->loadThumbnail(item->fullId());
+					--left;
+				}
+			}
+		}
+	}
+}
+
+void Preloader::markWarm(not_null<History*> history) {
+	_warm.erase(ranges::remove(_warm, history), end(_warm));
+	_warm.push_back(history);
+	while (int(_warm.size()) > kKeepWarmCount) {
+		const auto evicted = _warm.front();
+		_warm.pop_front();
+		if (evicted != _shown
+			&& !ranges::contains(_queue, evicted)
+			&& !shownInSomeWindow(evicted)) {
+			evicted->clear(History::ClearType::Unload);
+		}
+	}
+}
+
+bool Preloader::shownInSomeWindow(not_null<History*> history) const {
+	return ranges::any_of(_session->windows(), [&](
+			not_null<Window::SessionController*> window) {
+		return (window->activeChatCurrent().history() == history);
+	});
+}
+
+void Preloader::shown(not_null<History*> history, bool ready) {
+	if (_shown == history) {
+		return;
+	}
+	_shown = history;
+
+	// The history widget loads it by itself from now on.
+	cancel(history);
+	auto stats = _stats.current();
+	const auto i = ranges::find(_warm, history);
+	if (i != end(_warm) && ready) {
+		++stats.hits;
+		_warm.erase(i);
+	} else {
+		++stats.misses;
+	}
+	_stats = stats;
+	const auto total = stats.hits + stats.misses;
+	DEBUG_LOG(("Support Preload: %1 hits of %2 shown chats (%3%)."
+		).arg(stats.hits
+		).arg(total
+		).arg(stats.hits * 100 / total));
+}
+
+auto Preloader::statsValue() const -> rpl::producer<Stats> {
+	return _stats.value();
+}
+
 } // namespace Support
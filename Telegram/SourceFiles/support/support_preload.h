@@ -7,13 +7,68 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/timer.h"
+#include "base/weak_ptr.h"
+
 class History;
 
+namespace Main {
+class Session;
+} // namespace Main
+
 namespace Support {
 
 // Returns histories().request, not api().request.
 [[nodiscard]] int SendPreloadRequest(
 	not_null<History*> history,
-	Fn<void()> retry);
+	Fn<void()> retry,
+	Fn<void()> done = nullptr,
+	Fn<void()> fail = nullptr);
+
+// Keeps the next chats in the operator queue loaded in the background.
+class Preloader final : public base::has_weak_ptr {
+public:
+	explicit Preloader(not_null<Main::Session*> session);
+	~Preloader();
+
+	// Histories in the order they're going to be opened.
+	void setQueue(std::vector<not_null<History*>> queue);
+
+	// Should be called when a history is opened, updates the hit rate.
+	void shown(not_null<History*> history, bool ready);
+
+	struct Stats {
+		int hits = 0; // Opened chats that were already preloaded.
+		int misses = 0;
+
+		friend inline bool operator==(Stats, Stats) = default;
+	};
+	[[nodiscard]] rpl::producer<Stats> statsValue() const;
+
+private:
+	struct Request {
+		not_null<History*> history;
+		int requestId = 0; // Not real mtpRequestId.
+	};
+
+	void sendNext();
+	void cancel(not_null<History*> history);
+	void loaded(not_null<History*> history);
+	void failed(not_null<History*> history);
+	[[nodiscard]] bool failedRecently(not_null<History*> history) const;
+	void preloadMedia(not_null<History*> history);
+	void markWarm(not_null<History*> history);
+	[[nodiscard]] bool shownInSomeWindow(not_null<History*> history) const;
+
+	const not_null<Main::Session*> _session;
+	std::vector<not_null<History*>> _queue;
+	std::vector<Request> _requests;
+	std::deque<not_null<History*>> _warm; // Least recently used first.
+	base::flat_map<not_null<History*>, crl::time> _failed;
+	base::Timer _retryTimer;
+	History *_shown = nullptr;
+	rpl::variable<Stats> _stats;
+
+};
 
 } // namespace Support
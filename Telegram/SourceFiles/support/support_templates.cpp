@@ -271,39 +271,32 @@ FilesResult ReadFiles(const QString &folder) {
 }
 
 TemplatesIndex ComputeIndex(const TemplatesData &data) {
-	using Id = TemplatesIndex::Id;
-	using Term = TemplatesIndex::Term;
-
-	auto uniqueFirst = std::map<QChar, base::flat_set<Id>>();
-	auto uniqueFull = std::map<Id, base::flat_set<Term>>();
-	const auto pushString = [&](
-			const Id &id,
-			const QString &string,
-			int weight) {
+	using Posting = TemplatesIndex::Posting;
+
+	auto result = TemplatesIndex();
+	auto unique = base::flat_set<std::pair<QString, int>>();
+	const auto pushString = [&](const QString &string, int weight) {
 		const auto list = TextUtilities::PrepareSearchWords(string);
 		for (const auto &word : list) {
-			uniqueFirst[word[0]].emplace(id);
-			uniqueFull[id].emplace(std::make_pair(word, weight));
+			unique.emplace(word, weight);
 		}
 	};
 	for (const auto &[path, file] : data.files) {
 		for (const auto &[normalized, question] : file.questions) {
-			const auto id = std::make_pair(path, normalized);
+			const auto index = int(result.questions.size());
+			result.questions.emplace_back(path, normalized);
 			for (const auto &key : question.normalizedKeys) {
-				pushString(id, key, kWeightStep * kWeightStep);
+				pushString(key, kWeightStep * kWeightStep);
+				result.keys[key].push_back(index);
 			}
-			pushString(id, question.question, kWeightStep);
-			pushString(id, question.value, 1);
+			pushString(question.question, kWeightStep);
+			pushString(question.value, 1);
+			for (const auto &[word, weight] : unique) {
+				result.terms[word].push_back(Posting{ index, weight });
+			}
+			unique.clear();
 		}
 	}
-
-	auto result = TemplatesIndex();
-	for (const auto &[ch, unique] : uniqueFirst) {
-		result.first.emplace(ch, unique | ranges::to_vector);
-	}
-	for (const auto &[id, unique] : uniqueFull) {
-		result.full.emplace(id, unique | ranges::to_vector);
-	}
 	return result;
 }
 
@@ -311,34 +304,62 @@ void ReplaceFileIndex(
 		TemplatesIndex &result,
 		TemplatesIndex &&source,
 		const QString &path) {
-	for (auto i = begin(result.full); i != end(result.full);) {
-		if (i->first.first == path) {
-			i = result.full.erase(i);
-		} else {
-			++i;
+	using Posting = TemplatesIndex::Posting;
+
+	// Drop the questions of the replaced file and compact the rest,
+	// so that the index doesn't grow with each reload.
+	const auto count = int(result.questions.size());
+	auto remap = std::vector<int>(count, -1);
+	auto kept = 0;
+	for (auto i = 0; i != count; ++i) {
+		if (result.questions[i].first != path) {
+			if (kept != i) {
+				result.questions[kept] = std::move(result.questions[i]);
+			}
+			remap[i] = kept++;
 		}
 	}
-	for (auto &[id, list] : source.full) {
-		result.full.emplace(id, std::move(list));
+	if (kept != count) {
+		result.questions.resize(kept);
+		for (auto i = begin(result.terms); i != end(result.terms);) {
+			auto &list = i->second;
+			for (auto &posting : list) {
+				posting.question = remap[posting.question];
+			}
+			list.erase(
+				ranges::remove(list, -1, &Posting::question),
+				end(list));
+			i = list.empty() ? result.terms.erase(i) : std::next(i);
+		}
+		for (auto i = begin(result.keys); i != end(result.keys);) {
+			auto &list = i->second;
+			for (auto &question : list) {
+				question = remap[question];
+			}
+			list.erase(ranges::remove(list, -1), end(list));
+			i = list.empty() ? result.keys.erase(i) : std::next(i);
+		}
 	}
 
-	using Id = TemplatesIndex::Id;
-	for (auto &[ch, list] : result.first) {
-		auto i = ranges::lower_bound(
-			list,
-			std::make_pair(path, QString()));
-		auto j = std::find_if(i, end(list), [&](const Id &id) {
-			return id.first != path;
-		});
-		list.erase(i, j);
+	const auto shift = int(result.questions.size());
+	result.questions.insert(
+		end(result.questions),
+		std::make_move_iterator(begin(source.questions)),
+		std::make_move_iterator(end(source.questions)));
+	for (auto &[word, list] : source.terms) {
+		auto &to = result.terms[word];
+		for (const auto &posting : list) {
+			to.push_back({ posting.question + shift, posting.weight });
+		}
 	}
-	for (auto &[ch, list] : source.first) {
-		auto &to = result.first[ch];
-		to.insert(
-			end(to),
-			std::make_move_iterator(begin(list)),
-			std::make_move_iterator(end(list)));
-		ranges::sort(to);
+	for (auto &[key, list] : source.keys) {
+		auto &to = result.keys[key];
+		for (const auto question : list) {
+			to.push_back(question + shift);
+		}
+		ranges::sort(to, std::less<>(), [&](int question) {
+			return result.questions[question];
+		});
 	}
 }
 
@@ -562,10 +583,17 @@ void Templates::updateRequestFinished(QNetworkReply *reply) {
 	LOG(("Got template from url '%1'"
 		).arg(reply->url().toDisplayString()));
 	const auto content = reply->readAll();
-	crl::async([=, weak = base::make_weak(this)]{
+	crl::async([
+		=,
+		local = _data.files.at(path),
+		weak = base::make_weak(this)
+	] {
 		auto result = ReadFromBlob(content);
 		auto one = TemplatesData();
 		one.files.emplace(path, std::move(result.result));
+
+		// The local keys are kept, so the index is built with them.
+		MoveKeys(one.files.at(path), local);
 		auto index = ComputeIndex(one);
 		crl::on_main(weak,[
 			=,
@@ -575,8 +603,7 @@ void Templates::updateRequestFinished(QNetworkReply *reply) {
 		]() mutable {
 			auto &existing = _data.files.at(path);
 			auto &parsed = one.files.at(path);
-			MoveKeys(parsed, existing);
-			ReplaceFileIndex(_index, ComputeIndex(one), path);
+			ReplaceFileIndex(_index, std::move(index), path);
 			if (!errors.isEmpty()) {
 				_errors.fire(std::move(errors));
 			}
@@ -618,16 +645,11 @@ auto Templates::matchExact(QString query) const
 
 	query = NormalizeKey(query);
 
-	for (const auto &[path, file] : _data.files) {
-		for (const auto &[normalized, question] : file.questions) {
-			for (const auto &key : question.normalizedKeys) {
-				if (key == query) {
-					return QuestionByKey{ question, key };
-				}
-			}
-		}
+	const auto i = _index.keys.find(query);
+	if (i == end(_index.keys)) {
+		return {};
 	}
-	return {};
+	return QuestionByKey{ questionByIndex(i->second.front()), i->first };
 }
 
 auto Templates::matchFromEnd(QString query) const
@@ -636,104 +658,97 @@ auto Templates::matchFromEnd(QString query) const
 		query = query.mid(query.size() - _maxKeyLength);
 	}
 
+	// Check the longest suffixes first, the longest matching key wins.
 	const auto size = query.size();
-	auto queries = std::vector<QString>();
-	queries.reserve(size);
-	for (auto i = 0; i != size; ++i) {
-		queries.push_back(NormalizeKey(query.mid(size - i - 1)));
-	}
-
-	auto result = std::optional<QuestionByKey>();
-	for (const auto &[path, file] : _data.files) {
-		for (const auto &[normalized, question] : file.questions) {
-			for (const auto &key : question.normalizedKeys) {
-				if (key.size() <= queries.size()
-					&& queries[key.size() - 1] == key
-					&& (!result || result->key.size() <= key.size())) {
-					result = QuestionByKey{ question, key };
-				}
-			}
+	for (auto i = size; i != 0; --i) {
+		const auto key = NormalizeKey(query.mid(size - i));
+		if (key.size() != i) {
+			continue;
+		}
+		const auto j = _index.keys.find(key);
+		if (j != end(_index.keys)) {
+			return QuestionByKey{ questionByIndex(j->second.back()), key };
 		}
 	}
-	return result;
+	return {};
+}
+
+auto Templates::questionByIndex(int index) const -> const Question & {
+	const auto &[path, normalized] = _index.questions[index];
+	return _data.files.at(path).questions.at(normalized);
 }
 
 Templates::~Templates() = default;
 
 auto Templates::query(const QString &text) const -> std::vector<Question> {
 	const auto words = TextUtilities::PrepareSearchWords(text);
-	const auto questions = [&](const QString &word) {
-		const auto i = _index.first.find(word[0]);
-		return (i == end(_index.first)) ? 0 : i->second.size();
-	};
-	const auto best = ranges::min_element(words, std::less<>(), questions);
-	if (best == std::end(words)) {
+	if (words.isEmpty()) {
 		return {};
 	}
-	const auto narrowed = _index.first.find((*best)[0]);
-	if (narrowed == end(_index.first)) {
-		return {};
-	}
-	using Id = TemplatesIndex::Id;
-	using Term = TemplatesIndex::Term;
-	const auto questionById = [&](const Id &id) {
-		return _data.files.at(id.first).questions.at(id.second);
-	};
 
-	const auto computeWeight = [&](const Id &id) {
-		auto result = 0;
-		const auto full = _index.full.find(id);
-		for (const auto &word : words) {
-			const auto from = ranges::lower_bound(
-				full->second,
-				word,
-				std::less<>(),
-				[](const Term &term) { return term.first; });
-			const auto till = std::find_if(
-				from,
-				end(full->second),
-				[&](const Term &term) {
-					return !term.first.startsWith(word);
-				});
-			const auto weight = std::max_element(
-				from,
-				till,
-				[](const Term &a, const Term &b) {
-					return a.second < b.second;
-				});
-			if (weight == till) {
-				return 0;
+	// For each word take the best weighted term starting with it,
+	// doubled if that term is the word itself, and sum over all words.
+	// Questions that don't have a term for some word are skipped.
+	const auto count = int(_index.questions.size());
+	auto total = std::vector<int>(count, 0);
+	auto matched = std::vector<int>(count, 0);
+	auto best = std::vector<int>(count, 0);
+	auto exact = std::vector<char>(count, 0);
+	auto touched = std::vector<int>();
+	for (const auto &word : words) {
+		const auto from = _index.terms.lower_bound(word);
+		for (auto i = from; i != end(_index.terms); ++i) {
+			if (!i->first.startsWith(word)) {
+				break;
+			}
+			const auto isExact = (i->first == word);
+			for (const auto &[question, weight] : i->second) {
+				if (!best[question]) {
+					touched.push_back(question);
+				}
+				if (weight > best[question]) {
+					best[question] = weight;
+					exact[question] = isExact ? 1 : 0;
+				}
 			}
-			result += weight->second * (weight->first == word ? 2 : 1);
 		}
-		return result;
-	};
-	using Pair = std::pair<Id, int>;
-	const auto pairById = [&](const Id &id) {
-		return std::make_pair(id, computeWeight(id));
-	};
-	const auto sorter = [](const Pair &a, const Pair &b) {
+		for (const auto question : touched) {
+			total[question] += best[question] * (exact[question] ? 2 : 1);
+			++matched[question];
+			best[question] = 0;
+		}
+		touched.clear();
+	}
+
+	using Pair = std::pair<int, int>;
+	auto good = std::vector<Pair>();
+	for (auto i = 0; i != count; ++i) {
+		if (matched[i] == int(words.size())) {
+			good.emplace_back(i, total[i]);
+		}
+	}
+	const auto sorter = [&](const Pair &a, const Pair &b) {
 		// weight DESC filename DESC question ASC
+		const auto &aid = _index.questions[a.first];
+		const auto &bid = _index.questions[b.first];
 		if (a.second > b.second) {
 			return true;
 		} else if (a.second < b.second) {
 			return false;
-		} else if (a.first.first > b.first.first) {
+		} else if (aid.first > bid.first) {
 			return true;
-		} else if (a.first.first < b.first.first) {
+		} else if (aid.first < bid.first) {
 			return false;
 		} else {
-			return (a.first.second < b.first.second);
+			return (aid.second < bid.second);
 		}
 	};
-	const auto good = narrowed->second | ranges::views::transform(
-		pairById
-	) | ranges::views::filter([](const Pair &pair) {
-		return pair.second > 0;
-	}) | ranges::to_vector | ranges::actions::stable_sort(sorter);
-	return good | ranges::views::transform([&](const Pair &pair) {
-		return questionById(pair.first);
-	}) | ranges::views::take(kQueryLimit) | ranges::to_vector;
+	const auto limit = std::min(int(good.size()), kQueryLimit);
+	ranges::partial_sort(good, begin(good) + limit, sorter);
+	return good | ranges::views::take(limit) | ranges::views::transform([&](
+			const Pair &pair) {
+		return questionByIndex(pair.first);
+	}) | ranges::to_vector;
 }
 
 } // namespace Support
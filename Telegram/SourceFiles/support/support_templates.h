@@ -36,10 +36,14 @@ struct TemplatesData {
 
 struct TemplatesIndex {
 	using Id = std::pair<QString, QString>; // filename, normalized question
-	using Term = std::pair<QString, int>; // search term, weight
+	struct Posting {
+		int question = 0; // index in 'questions'
+		int weight = 0;
+	};
 
-	std::map<QChar, std::vector<Id>> first;
-	std::map<Id, std::vector<Term>> full;
+	std::vector<Id> questions;
+	std::map<QString, std::vector<Posting>> terms;
+	std::map<QString, std::vector<int>> keys; // sorted by question Id
 };
 
 } // namespace details
@@ -78,6 +82,7 @@ private:
 	void updateRequestFinished(QNetworkReply *reply);
 	void checkUpdateFinished();
 	void setData(details::TemplatesData &&data);
+	[[nodiscard]] const Question &questionByIndex(int index) const;
 
 	not_null<Main::Session*> _session;
 